@@ -0,0 +1,76 @@
+// Micro-benchmark for the scalar and batch power / root kernels.
+// Build with -DIMETH_BUILD_BENCHMARKS=ON and a Release configuration, then run imeth_bench.
+//
+// "latency" feeds each result into the next call, so it measures one call's critical path;
+// "throughput" runs independent calls over an array.
+#include <imeth/operation/arithmetic.hpp>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <random>
+#include <vector>
+
+namespace {
+
+constexpr size_t N = 1 << 16;
+constexpr int REPEATS = 50;
+
+volatile double sink;
+
+template <typename F>
+double nanoseconds_per_value(F&& f) {
+    const auto start = std::chrono::steady_clock::now();
+    for (int r = 0; r < REPEATS; ++r) f();
+    const std::chrono::duration<double, std::nano> elapsed = std::chrono::steady_clock::now() - start;
+    return elapsed.count() / (static_cast<double>(REPEATS) * N);
+}
+
+template <typename F>
+void row(const char* name, const std::vector<double>& values, F&& f) {
+    std::vector<double> out(values.size());
+    const double latency = nanoseconds_per_value([&] {
+        double x = values[0];
+        for (size_t i = 0; i < N; ++i) x = f(x + values[i]) * 1e-300 + values[i];
+        sink = x;
+    });
+    const double throughput = nanoseconds_per_value([&] {
+        for (size_t i = 0; i < N; ++i) out[i] = f(values[i]);
+        sink = out[N / 2];
+    });
+    std::printf("%-24s %10.2f %12.2f\n", name, latency, throughput);
+}
+
+template <typename F>
+void batch_row(const char* name, const std::vector<double>& values, F&& f) {
+    std::vector<double> out(values.size());
+    const double throughput = nanoseconds_per_value([&] {
+        f(values, out);
+        sink = out[N / 2];
+    });
+    std::printf("%-24s %10s %12.2f\n", name, "-", throughput);
+}
+
+} // namespace
+
+int main() {
+    namespace A = imeth::Arithmetic;
+    std::mt19937_64 rng(42);
+    std::uniform_real_distribution<double> wide(-1e6, 1e6), unit(0.5, 1.5);
+    std::vector<double> values(N), positive(N), bases(N);
+    for (size_t i = 0; i < N; ++i) {
+        values[i] = wide(rng);
+        positive[i] = std::abs(values[i]);
+        bases[i] = unit(rng);
+    }
+
+    std::printf("%-24s %10s %12s   (ns per value)\n", "kernel", "latency", "throughput");
+    row("power(x, 13)", bases, [](double x) { return A::power(x, 13); });
+    row("std::pow(x, 13)", bases, [](double x) { return std::pow(x, 13.0); });
+    row("square_root", positive, [](double x) { return A::square_root(std::abs(x)); });
+    row("std::sqrt", positive, [](double x) { return std::sqrt(std::abs(x)); });
+    row("cube_root", values, [](double x) { return A::cube_root(x); });
+    row("std::cbrt", values, [](double x) { return std::cbrt(x); });
+    batch_row("power(span, 13)", bases, [](const auto& in, auto& out) { A::power(in, 13, out); });
+    batch_row("square_root(span)", positive, [](const auto& in, auto& out) { A::square_root(in, out); });
+    batch_row("cube_root(span)", values, [](const auto& in, auto& out) { A::cube_root(in, out); });
+}
@@ -1,33 +1,40 @@
-#include <imeth/operation/arithmetic.hpp>
+#include <imeth/operation/expression.hpp>
 #include <iostream>
+#include <stdexcept>
+#include <string>
+#include <vector>
 
 int main() {
-    double a, b;
-    char op;
+    std::string line;
 
     std::cout << "Simple Calculator\n";
-    std::cout << "Enter operation (e.g., 5 + 3): ";
-    std::cin >> a >> op >> b;
+    std::cout << "Enter an expression (e.g., 5 + 3 * 2): ";
+    std::getline(std::cin, line);
 
-    double result;
-    switch(op) {
-        case '+':
-            result = imeth::Arithmetic::add(a, b);
-            break;
-        case '-':
-            result = imeth::Arithmetic::subtract(a, b);
-            break;
-        case '*':
-            result = imeth::Arithmetic::multiply(a, b);
-            break;
-        case '/':
-            result = imeth::Arithmetic::divide(a, b);
-            break;
-        default:
-            std::cout << "Invalid operator!\n";
-            return 1;
+    try {
+        const imeth::Expression expression(line);
+        std::cout << "Result: " << expression.evaluate() << "\n";
+    } catch (const std::invalid_argument& e) {
+        std::cout << "Invalid expression: " << e.what() << "\n";
+        return 1;
     }
 
-    std::cout << "Result: " << result << "\n";
+    std::cout << "Enter a formula in x (e.g., x^2 - 2*x + 1): ";
+    std::getline(std::cin, line);
+
+    try {
+        // Compiled once, then evaluated for the whole table in one call
+        const imeth::Expression formula(line, {"x"});
+        std::vector<double> xs;
+        for (int i = 0; i <= 10; ++i) xs.push_back(i);
+        const std::vector<std::span<const double>> columns = {xs};
+        const std::vector<double> ys = formula.evaluate(columns);
+
+        for (size_t i = 0; i < xs.size(); ++i)
+            std::cout << "f(" << xs[i] << ") = " << ys[i] << "\n";
+    } catch (const std::invalid_argument& e) {
+        std::cout << "Invalid formula: " << e.what() << "\n";
+        return 1;
+    }
     return 0;
 }
@@ -1,4 +1,5 @@
 #include <imeth/operation/arithmetic.hpp>
+#include <imeth/operation/histogram.hpp>
 #include <iostream>
 #include <vector>
 #include <algorithm>
@@ -6,6 +7,7 @@
 #include <string>
 #include <sstream>
 #include <iomanip>
+#include <cmath>
 
 int main() {
     std::cout << "=== Data Statistics Calculator ===\n\n";
@@ -63,6 +65,20 @@ int main() {
     std::cout << "Maximum: " << max << "\n";
     std::cout << "Range: " << rng << "\n";
 
+    // Distribution: up to 10 equal-width bins between the minimum and the maximum
+    if (rng > 0) {
+        const size_t bins = std::min<size_t>(10, static_cast<size_t>(std::ceil(std::sqrt(data.size()))));
+        auto histogram = imeth::Statistics::Histogram::uniform(min, max, bins);
+        histogram.push(data);
+
+        std::cout << "\n--- Histogram ---\n";
+        for (size_t i = 0; i < histogram.bins(); ++i) {
+            std::cout << "[" << std::setw(8) << histogram.edges()[i] << ", " << std::setw(8) << histogram.edges()[i + 1]
+                      << (i + 1 == histogram.bins() ? "] " : ") ") << std::string(histogram.count(i), '#') << " "
+                      << histogram.count(i) << "\n";
+        }
+    }
+
     // Filter values above average using C++20 ranges
     auto above_avg = data | std::views::filter([avg](double x) { return x > avg; });
 
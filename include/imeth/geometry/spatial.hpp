@@ -0,0 +1,72 @@
+#pragma once
+#include "../linear/matrix.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+namespace imeth {
+namespace Spatial {
+    // Point sets are Matrix objects with one point per row and one coordinate per column.
+
+    // Euclidean distances between every row of a and every row of b (a.rows() x b.rows()),
+    // or their squares. Low dimensions use a tiled kernel that vectorizes across points; from
+    // GEMM_DIMENSION coordinates on, |a|^2 + |b|^2 - 2 a.b with the product done by the blocked
+    // matrix multiply, which is faster but loses relative accuracy for points much closer
+    // together than they are far from the origin.
+    constexpr size_t GEMM_DIMENSION = 64;
+    Matrix pairwise_distances(const Matrix& a, const Matrix& b, bool squared = false);
+    // Symmetric points x points matrix with an exact zero diagonal
+    Matrix pairwise_distances(const Matrix& points, bool squared = false);
+
+    struct Neighbor {
+        size_t index;     // row in the indexed point matrix
+        double distance;
+    };
+
+    // k nearest neighbours of many queries, row-major: entry q * k + j is the j-th nearest of query q
+    struct Neighbors {
+        size_t k{};
+        std::vector<size_t> indices;
+        std::vector<double> distances;
+    };
+
+    // k-d tree over a copy of the points, for nearest-neighbour and radius queries in any
+    // dimension. The tree is perfectly balanced: every node splits its points at the median of
+    // its widest coordinate, down to leaves of about leaf_size points stored contiguously.
+    // Construction sorts one tree level at a time with all nodes of the level in parallel;
+    // batched queries run in parallel over query rows. Results are sorted by distance, ties by
+    // index, so they do not depend on the thread count.
+    class KDTree {
+    public:
+        explicit KDTree(const Matrix& points, size_t leaf_size = 16);
+
+        size_t size() const;
+        size_t dimension() const;
+
+        // k must be in [1, size()]
+        std::vector<Neighbor> nearest(std::span<const double> query, size_t k) const;
+        Neighbors nearest(const Matrix& queries, size_t k) const;
+        // Every point at distance <= radius
+        std::vector<Neighbor> within(std::span<const double> query, double radius) const;
+        std::vector<std::vector<Neighbor>> within(const Matrix& queries, double radius) const;
+
+    private:
+        struct Node {
+            std::uint32_t dimension;  // split coordinate
+            double split;             // left subtree <= split <= right subtree
+        };
+
+        void check_query(size_t coordinates) const;
+        void search_nearest(const double* query, size_t k, std::vector<Neighbor>& heap) const;
+        void search_within(const double* query, double radius_squared, std::vector<Neighbor>& out) const;
+
+        size_t m_size;
+        size_t m_dimension;
+        size_t m_depth;                  // levels of inner nodes; leaves are at this depth
+        std::vector<double> m_points;    // coordinates in tree order, row-major
+        std::vector<size_t> m_index;     // original row of each tree-order point
+        std::vector<Node> m_nodes;       // heap order: children of node i are 2i + 1 and 2i + 2
+    };
+}; // namespace Spatial
+} // namespace imeth
@@ -0,0 +1,33 @@
+#pragma once
+#include "matrix.hpp"
+#include <cstdint>
+#include <vector>
+
+namespace imeth {
+namespace Decomposition {
+    // Thin QR: A (m x n, m >= n) = Q (m x n, orthonormal columns) * R (n x n, upper triangular)
+    struct QR {
+        Matrix Q;
+        Matrix R;
+    };
+
+    QR qr(const Matrix& A);
+
+    // A ~= U * diag(singular_values) * Vt, singular values in descending order
+    struct SVD {
+        Matrix U;                            // m x k
+        std::vector<double> singular_values; // k
+        Matrix Vt;                           // k x n
+    };
+
+    struct RandomizedSVDOptions {
+        size_t oversampling = 10;     // extra sample columns beyond the requested rank
+        size_t power_iterations = 2;  // subspace iterations, sharpen slowly decaying spectra
+        std::uint64_t seed = 42;
+    };
+
+    // Rank-k truncated SVD via a randomized range finder (Halko, Martinsson & Tropp).
+    // Costs O(m * n * (k + oversampling) * (2 * power_iterations + 2)) in parallel GEMMs.
+    SVD randomized_svd(const Matrix& A, size_t rank, const RandomizedSVDOptions& options = {});
+}; // namespace Decomposition
+} // namespace imeth
@@ -0,0 +1,55 @@
+#pragma once
+#include "matrix.hpp"
+#include "sparse.hpp"
+#include <cstdint>
+#include <functional>
+#include <span>
+#include <vector>
+
+namespace imeth {
+namespace EigenSolver {
+    // y = A * x for a symmetric operator A of dimension n
+    using MatVec = std::function<void(std::span<const double> x, std::span<double> y)>;
+
+    enum class Spectrum {
+        Largest,          // largest algebraic eigenvalues
+        Smallest,         // smallest algebraic eigenvalues
+        LargestMagnitude  // largest |lambda|
+    };
+
+    struct Options {
+        Spectrum which = Spectrum::Largest;
+        double tolerance = 1e-10;      // relative residual ||A v - lambda v|| / |lambda|
+        size_t max_iterations = 1000;  // matvec products (Lanczos: upper bound on basis size)
+        std::uint64_t seed = 42;       // starting vector seed, runs are reproducible
+    };
+
+    struct EigenPair {
+        double value{};
+        std::vector<double> vector;
+        size_t iterations{};
+        bool converged{};
+    };
+
+    struct EigenPairs {
+        std::vector<double> values;  // ordered according to Options::which
+        Matrix vectors;              // n x k, column i belongs to values[i]
+        size_t iterations{};
+        bool converged{};
+    };
+
+    // Dominant eigenpair (largest |lambda|) by the power method
+    EigenPair power_iteration(const MatVec& A, size_t n, const Options& options = {});
+    EigenPair power_iteration(const Matrix& A, const Options& options = {});
+    EigenPair power_iteration(const SparseMatrix& A, const Options& options = {});
+
+    // Eigenpair closest to `shift`; (A - shift I) is LU-factored once and reused
+    EigenPair inverse_iteration(const Matrix& A, double shift, const Options& options = {});
+
+    // k extreme eigenpairs of a symmetric operator by Lanczos with full reorthogonalization.
+    // Each step costs one matvec plus O(n * j) for reorthogonalization against the j basis vectors.
+    EigenPairs lanczos(const MatVec& A, size_t n, size_t k, const Options& options = {});
+    EigenPairs lanczos(const Matrix& A, size_t k, const Options& options = {});
+    EigenPairs lanczos(const SparseMatrix& A, size_t k, const Options& options = {});
+}; // namespace EigenSolver
+} // namespace imeth
@@ -1,6 +1,9 @@
 #pragma once
+#include <cstddef>
 #include <vector>
 #include <initializer_list>
+#include <span>
+#include <utility>
 
 namespace imeth {
     class Matrix {
@@ -14,10 +17,16 @@ namespace imeth {
         size_t rows() const;
         size_t cols() const;
 
+        // Row-major storage, rows() * cols() elements
+        double* data();
+        const double* data() const;
+
         static Matrix identity(size_t n);
 
         Matrix transpose() const;
         Matrix operator*(const Matrix& rhs) const;
+        Matrix transpose_multiply(const Matrix& rhs) const;  // this^T * rhs
+        Matrix multiply_transpose(const Matrix& rhs) const;  // this * rhs^T
         Matrix operator+(const Matrix& rhs) const;
         Matrix operator-(const Matrix& rhs) const;
 
@@ -37,6 +46,9 @@ namespace imeth {
 
         size_t size() const;
 
+        double* data();
+        const double* data() const;
+
     private:
         std::vector<double> m_data;
     };
@@ -45,6 +57,12 @@ namespace imeth {
         Vector gaussian_elimination(const Matrix& A, const Vector& b);
         Vector gauss_jordan(const Matrix& A, const Vector& b);
         Vector lu_decomposition(const Matrix& A, const Vector& b);
+
+        // Solves many independent systems in parallel (LU with partial pivoting, one workspace
+        // per worker). Results are in input order regardless of scheduling.
+        std::vector<Vector> batch_solve(const std::vector<std::pair<Matrix, Vector>>& systems);
+        // Strided layout: A holds row-major n x n blocks back to back, b and x hold length-n blocks
+        void batch_solve(std::span<const double> A, std::span<const double> b, std::span<double> x, size_t n);
     };
 
 } // namespace imeth
\ No newline at end of file
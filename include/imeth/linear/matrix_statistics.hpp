@@ -0,0 +1,41 @@
+#pragma once
+#include "matrix.hpp"
+#include <vector>
+
+namespace imeth {
+namespace MatrixStatistics {
+    // Per-column (or per-row) reductions computed straight from Matrix storage.
+    // Variance is the population variance (divides by the count), like Probability::Functions::variance.
+    struct Summary {
+        size_t count{};  // values per column (or row)
+        std::vector<double> sum;
+        std::vector<double> average;
+        std::vector<double> variance;
+        std::vector<double> minimum;
+        std::vector<double> maximum;
+    };
+
+    // One pass over the matrix: vectorized across columns, parallel across row blocks
+    Summary describe_columns(const Matrix& M);
+    Summary describe_rows(const Matrix& M);
+
+    std::vector<double> column_sum(const Matrix& M);
+    std::vector<double> column_average(const Matrix& M);
+    std::vector<double> column_variance(const Matrix& M);
+    std::vector<double> column_minimum(const Matrix& M);
+    std::vector<double> column_maximum(const Matrix& M);
+
+    std::vector<double> row_sum(const Matrix& M);
+    std::vector<double> row_average(const Matrix& M);
+    std::vector<double> row_variance(const Matrix& M);
+    std::vector<double> row_minimum(const Matrix& M);
+    std::vector<double> row_maximum(const Matrix& M);
+
+    // Linear-interpolated quantiles, p in [0, 1]. Result is probabilities.size() x cols
+    // (or x rows): entry (i, j) is quantile probabilities[i] of column (row) j.
+    Matrix column_quantiles(const Matrix& M, const std::vector<double>& probabilities);
+    Matrix row_quantiles(const Matrix& M, const std::vector<double>& probabilities);
+    std::vector<double> column_median(const Matrix& M);
+    std::vector<double> row_median(const Matrix& M);
+}; // namespace MatrixStatistics
+} // namespace imeth
@@ -0,0 +1,51 @@
+#pragma once
+#include <cstddef>
+#include <span>
+#include <vector>
+
+namespace imeth {
+    class Matrix;
+
+    // Compressed sparse row (CSR) matrix
+    class SparseMatrix {
+    public:
+        struct Triplet {
+            size_t row;
+            size_t col;
+            double value;
+        };
+
+        SparseMatrix(size_t rows, size_t cols);
+        // Duplicate (row, col) entries are summed
+        SparseMatrix(size_t rows, size_t cols, const std::vector<Triplet>& entries);
+
+        static SparseMatrix from_dense(const Matrix& dense, double drop_tolerance = 0.0);
+        static SparseMatrix identity(size_t n);
+
+        size_t rows() const;
+        size_t cols() const;
+        size_t nonzeros() const;
+
+        // Returns 0 for entries outside the sparsity pattern
+        double operator()(size_t r, size_t c) const;
+
+        const std::vector<size_t>& row_offsets() const;
+        const std::vector<size_t>& column_indices() const;
+        const std::vector<double>& values() const;
+        std::vector<double>& values();
+
+        // y = A * x, x.size() == cols(), y.size() == rows()
+        void multiply(std::span<const double> x, std::span<double> y) const;
+        std::vector<double> operator*(const std::vector<double>& x) const;
+
+        SparseMatrix transpose() const;
+        Matrix to_dense() const;
+
+    private:
+        size_t m_rows{};
+        size_t m_cols{};
+        std::vector<size_t> m_row_offsets;
+        std::vector<size_t> m_column_indices;
+        std::vector<double> m_values;
+    };
+} // namespace imeth
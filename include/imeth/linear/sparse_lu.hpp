@@ -0,0 +1,65 @@
+#pragma once
+#include "sparse.hpp"
+#include <cstddef>
+#include <span>
+#include <vector>
+
+namespace imeth {
+    // Sparse direct solver: P * A * Q = L * U, factored column by column (Gilbert-Peierls).
+    //
+    // analyze()     - fill-reducing column ordering Q, computed from the pattern of A + A^T
+    // factorize()   - numeric factorization with threshold partial pivoting (prefers the diagonal)
+    // refactorize() - reuses the pivot sequence and the L/U patterns of the last factorize(),
+    //                 only recomputing values; much cheaper for a new matrix with the same pattern
+    class SparseLU {
+    public:
+        enum class Ordering {
+            Natural,       // Q = I
+            MinimumDegree  // approximate minimum degree (AMD) on the symmetrized pattern
+        };
+
+        SparseLU() = default;
+        // analyze() followed by factorize()
+        explicit SparseLU(const SparseMatrix& A, Ordering ordering = Ordering::MinimumDegree);
+
+        void analyze(const SparseMatrix& A, Ordering ordering = Ordering::MinimumDegree);
+        void factorize(const SparseMatrix& A);
+        void refactorize(const SparseMatrix& A);
+
+        void solve(std::span<const double> b, std::span<double> x) const;
+        std::vector<double> solve(const std::vector<double>& b) const;
+
+        size_t size() const;
+        const std::vector<size_t>& column_permutation() const;
+        size_t nonzeros_L() const;  // excluding the unit diagonal
+        size_t nonzeros_U() const;  // including the diagonal
+
+        // Relative threshold for accepting the diagonal entry as pivot, in (0, 1]
+        double pivot_tolerance = 1e-3;
+
+    private:
+        void check_pattern(const SparseMatrix& A) const;
+        void gather_columns(const SparseMatrix& A);
+
+        size_t m_n{};
+        bool m_analyzed{};
+        bool m_factorized{};
+
+        // Symbolic data, valid for every matrix with the analyzed pattern
+        std::vector<size_t> m_row_offsets;     // pattern of A, checked on factorize
+        std::vector<size_t> m_column_indices;
+        std::vector<size_t> m_q;               // column k of A*Q is column m_q[k] of A
+        std::vector<size_t> m_col_start;       // CSC view of A
+        std::vector<size_t> m_col_rows;
+        std::vector<size_t> m_csr_to_csc;      // value position map, CSR index -> CSC index
+        std::vector<double> m_col_values;
+
+        // Numeric factors; L rows are original row indices, U rows are pivot steps
+        std::vector<size_t> m_pivot_row;       // row of A pivoted at step k
+        std::vector<size_t> m_L_start, m_L_rows;
+        std::vector<double> m_L_values;
+        std::vector<size_t> m_U_start, m_U_rows; // off-diagonal, in topological order
+        std::vector<double> m_U_values;
+        std::vector<double> m_U_diag;
+    };
+} // namespace imeth
@@ -1,4 +1,6 @@
 #pragma once
+#include "sequence_view.hpp"
+#include <span>
 #include <vector>
 
 namespace imeth {
@@ -13,10 +15,22 @@ namespace Arithmetic {
     double modulo(double a, double b);
 
     // Power and Roots
+    // Fixed cost whatever the value: power squares its way through the exponent bits for
+    // |exponent| <= 64 (at most 12 multiplies; negative exponents give the reciprocal) and calls
+    // std::pow beyond that, square_root is the correctly rounded hardware instruction, cube_root
+    // refines a bit-level estimate a fixed number of times and stays within 0.75 ulp.
+    // Squaring loses about 0.8 * |exponent| ulp (up to ~50 ulp at 64); use std::pow directly
+    // when every exponent needs full accuracy.
     double power(double base, int exponent);
     double square_root(double n);
     double cube_root(double n);
 
+    // Batch versions, out[i] = f(numbers[i]), SIMD-width lanes at a time (threaded for millions
+    // of values). out must have the same size as the input and may be the same buffer.
+    void power(std::span<const double> bases, int exponent, std::span<double> out);
+    void square_root(std::span<const double> numbers, std::span<double> out); // throws if any value is negative
+    void cube_root(std::span<const double> numbers, std::span<double> out);
+
     // Absolute Value and Sign
     double absolute(double n);
     int absolute(int n); // don't mind me
@@ -38,7 +52,38 @@ namespace Arithmetic {
     double minimum(const std::vector<double>& numbers);
     double maximum(const std::vector<double>& numbers);
     double range(const std::vector<double>& numbers);
-    double median(std::vector<double> numbers); // Note: not const because we sort
+    double median(std::vector<double> numbers); // Note: by value; pass with std::move to skip the copy
+
+    // How a sum accumulates; every method runs vectorized.
+    enum class Summation {
+        Naive,     // plain accumulation in 16 lanes; fastest, error can grow with n
+        Pairwise,  // recursive halving; error grows with log n, nearly as fast as Naive
+        Neumaier   // Kahan-Babuska compensation; error independent of n, about 2x the cost
+    };
+
+    // Vectorized (AVX2/AVX-512 when the CPU has it) reductions over any contiguous buffer.
+    // Floats are summed in double precision. Buffers of a million or more elements are split
+    // across threads; the summation order is fixed by the data size alone, so results are
+    // bit-identical whatever the thread count. minimum, maximum and range skip NaN elements,
+    // unless the first element is NaN, which makes the result NaN.
+    double sum(std::span<const double> numbers, Summation method = Summation::Naive);
+    double sum(std::span<const float> numbers, Summation method = Summation::Naive);
+    double average(std::span<const double> numbers, Summation method = Summation::Naive);
+    double average(std::span<const float> numbers, Summation method = Summation::Naive);
+    double minimum(std::span<const double> numbers);
+    float minimum(std::span<const float> numbers);
+    double maximum(std::span<const double> numbers);
+    float maximum(std::span<const float> numbers);
+    double range(std::span<const double> numbers);
+    float range(std::span<const float> numbers);
+
+    // Order statistics by selection (average O(n), no full sort). Quantiles interpolate linearly
+    // between neighbouring order statistics, p in [0, 1]; quantile(x, 0.5) equals median(x).
+    // The in-place variants reorder `numbers` instead of copying it.
+    double median_in_place(std::span<double> numbers);
+    double quantile(std::span<const double> numbers, double p);
+    std::vector<double> quantiles(std::span<const double> numbers, const std::vector<double>& probabilities);
+    std::vector<double> quantiles_in_place(std::span<double> numbers, const std::vector<double>& probabilities);
 
     // Fractions (simplified as doubles)
     double add_fractions(double num1, double den1, double num2, double den2);
@@ -56,6 +101,8 @@ namespace Arithmetic {
     bool is_even(int n);
     bool is_odd(int n);
     bool is_prime(int n);
+    // Binary GCD on the magnitudes (see NumberTheory for 64-bit and array versions); throws
+    // std::overflow_error when the result does not fit in int, e.g. lcm(65536, 65537)
     int greatest_common_divisor(int a, int b);
     int least_common_multiple(int a, int b);
 
@@ -67,9 +114,25 @@ namespace Arithmetic {
     double simple_interest(double principal, double rate, double time);
 
     // Sequences
+    // What the uint_t sequence functions do when the exact result does not fit in 64 bits
+    enum class Overflow {
+        Throw,     // std::overflow_error (the default)
+        Saturate,  // the largest uint_t
+        Wrap       // the exact result modulo 2^64, like plain unsigned arithmetic
+    };
+
+    // Results are computed exactly (in 128 bits where needed), so sequence_sum is right whenever
+    // the sum itself fits, even if first + last or the product with terms does not. Checking costs
+    // a flag test or two per call. Terms are numbered from 1; nth_term(.., 0) throws
+    // std::invalid_argument.
     void sequence(uint_t first, uint_t diff, unsigned int terms,
-                                std::vector<uint_t>& result);
-    uint_t sequence_sum(uint_t first, uint_t last, unsigned int terms);
-    uint_t nth_term(uint_t first, uint_t diff, unsigned int n);
+                                std::vector<uint_t>& result, Overflow overflow = Overflow::Throw);
+    // Lazy view of the same terms; nothing is stored and terms wrap (see sequence_view.hpp)
+    ArithmeticSequence sequence(uint_t first, uint_t diff, uint_t terms);
+    uint_t sequence_sum(uint_t first, uint_t last, unsigned int terms, Overflow overflow = Overflow::Throw);
+    uint_t nth_term(uint_t first, uint_t diff, unsigned int n, Overflow overflow = Overflow::Throw);
+    // The exact results modulo a modulus > 0; these never overflow
+    uint_t sequence_sum_mod(uint_t first, uint_t last, unsigned int terms, uint_t modulus);
+    uint_t nth_term_mod(uint_t first, uint_t diff, unsigned int n, uint_t modulus);
 }; // namespace arithmetic
 } // namespace imeth
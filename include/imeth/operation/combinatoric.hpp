@@ -5,6 +5,7 @@
 #ifndef IMETH_COMBINATORIC_H
 #define IMETH_COMBINATORIC_H
 
+#include "arithmetic.hpp"
 #include <vector>
 #include <array>
 
@@ -129,9 +130,14 @@ namespace imeth::Combinatorics {
             double conditional_probability(double p_both, double p_condition);
             double total_probability(const std::vector<double>& event_probs, const std::vector<double>& conditional_probs);
             double bayes_theorem(double p_b_given_a, double p_a, double p_b);
-            double expected_value(const std::vector<double>& values, const std::vector<double>& probabilities);
-            double variance(const std::vector<double>& values, const std::vector<double>& probabilities);
-            double standard_deviation(const std::vector<double>& values, const std::vector<double>& probabilities);
+            // Weighted sums over the first min(values.size(), probabilities.size()) entries. The
+            // Summation method picks accuracy vs speed; Neumaier also captures each product's rounding error.
+            double expected_value(const std::vector<double>& values, const std::vector<double>& probabilities,
+                                  Arithmetic::Summation method = Arithmetic::Summation::Naive);
+            double variance(const std::vector<double>& values, const std::vector<double>& probabilities,
+                            Arithmetic::Summation method = Arithmetic::Summation::Naive);
+            double standard_deviation(const std::vector<double>& values, const std::vector<double>& probabilities,
+                                      Arithmetic::Summation method = Arithmetic::Summation::Naive);
         }
     }
 
@@ -192,6 +198,8 @@ namespace imeth::Combinatorics {
     namespace Sequences {
         void geometric_sequence(uint_t first, uint_t ratio, unsigned int terms,
                                 std::vector<uint_t>& result);
+        // Lazy view of the same terms; nothing is stored (see sequence_view.hpp)
+        GeometricSequence geometric_sequence(uint_t first, uint_t ratio, uint_t terms);
         uint_t geometric_sum(uint_t first, uint_t ratio, unsigned int terms);
         uint_t nth_term_geometric(uint_t first, uint_t ratio, unsigned int n);
     }
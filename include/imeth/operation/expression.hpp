@@ -0,0 +1,80 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace imeth {
+    // A formula compiled once and evaluated many times, one row at a time or over whole columns.
+    //
+    // Grammar, loosest binding first:
+    //   a + b, a - b      a * b, a / b, a % b      -a, +a      a ^ b (right associative, so
+    //   2 ^ 3 ^ 2 = 2 ^ 9 and -2 ^ 2 = -4)      numbers like 4, 2.5, 1e-3, names, f(args), (a)
+    // Names are the variables given at compile time plus the constants pi and e. Functions:
+    //   sqrt cbrt abs exp ln log10 log2 sin cos tan asin acos atan floor ceil round
+    //   min(a, b) max(a, b) pow(a, b) atan2(y, x) hypot(a, b)
+    //
+    // Compilation folds every subexpression that does not depend on a variable, turns ^ with a
+    // small constant integer exponent (|n| <= 64) into binary exponentiation like
+    // Arithmetic::power, and drops operations that cannot change the value (x * 1, x / 1, x - 0,
+    // x ^ 1, -(-x)). What is left becomes register bytecode: each instruction reads registers,
+    // variables or constants and writes one register.
+    //
+    // Batched evaluation runs the program over blocks of rows, one instruction at a time across a
+    // whole block, so each instruction is a tight loop the compiler vectorizes and the dispatch
+    // cost is shared by every row of the block. Large batches are split across threads.
+    //
+    // Arithmetic follows IEEE rules rather than throwing per row: x / 0 is infinite, sqrt(-1)
+    // and 0 / 0 are NaN. Row and batch evaluation give the same numbers (NaN payloads aside).
+    class Expression {
+    public:
+        // Throws std::invalid_argument with the position of the first syntax error, unknown
+        // name or wrong argument count. Variable names must be distinct.
+        explicit Expression(std::string_view formula, std::vector<std::string> variables = {});
+
+        const std::vector<std::string>& variables() const;
+        size_t instructions() const;  // after folding; 0 for a constant or a bare variable
+        bool is_constant() const;
+
+        // One row: values[i] is the value of variables()[i]
+        double evaluate(std::span<const double> values = {}) const;
+
+        // Columns: columns[i] holds variable i for every row, out[r] gets row r. Every column
+        // must have out.size() values; out may be one of the columns.
+        void evaluate(std::span<const std::span<const double>> columns, std::span<double> out) const;
+        std::vector<double> evaluate(std::span<const std::span<const double>> columns) const;
+
+    private:
+        enum class Op : std::uint8_t {
+            Add, Subtract, Multiply, Divide, Modulo, Power, PowerInt, Negate,
+            Sqrt, Cbrt, Abs, Exp, Ln, Log10, Log2, Sin, Cos, Tan, Asin, Acos, Atan,
+            Floor, Ceil, Round, Min, Max, Atan2, Hypot
+        };
+
+        struct Operand {
+            enum class Source : std::uint8_t { Register, Variable, Constant };
+            Source source;
+            std::uint32_t index;
+        };
+
+        struct Instruction {
+            Op op;
+            std::uint32_t target;  // register
+            Operand a, b;          // b is unused by one-argument operations
+            int exponent;          // PowerInt only
+        };
+
+        class Compiler;
+        static double apply(Op op, double a, double b, int exponent);
+        void run(std::span<const std::span<const double>> columns, size_t lo, size_t hi,
+                 double* out, double* scratch) const;
+
+        std::vector<std::string> m_variables;
+        std::vector<Instruction> m_code;
+        std::vector<double> m_constants;
+        Operand m_result{};
+        std::uint32_t m_registers{};
+    };
+} // namespace imeth
@@ -0,0 +1,67 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+namespace imeth {
+namespace Statistics {
+    // Counts of values per bin, for streams of any length. Bins are half-open [edge i, edge i + 1)
+    // except the last, which also takes the upper edge itself; values outside go to underflow()
+    // or overflow(), and NaN is ignored.
+    //
+    // Three layouts, all exact against edges():
+    // uniform     - equal widths; the bin comes from one multiply, checked against the edges
+    // logarithmic - equal ratios; the same on a fast log2 of the value
+    // edges       - any increasing edges; branchless binary search
+    //
+    // A span push costs O(values), whatever the number of bins. Large pushes are split across
+    // threads, each counting into private counters that are added up at the end, so threads
+    // never share a cache line while counting; with over a million bins the private counters
+    // would cost more than they save, and the calling thread counts alone.
+    class Histogram {
+    public:
+        // Edges must be finite and strictly increasing, at least two of them
+        explicit Histogram(std::vector<double> edges);
+        static Histogram uniform(double low, double high, size_t bins);
+        static Histogram logarithmic(double low, double high, size_t bins);  // needs 0 < low
+
+        void push(double value);
+        void push(std::span<const double> values);
+        // Both histograms must have the same edges
+        void merge(const Histogram& other);
+        Histogram& operator+=(const Histogram& other);
+        void reset();
+
+        size_t bins() const;
+        const std::vector<double>& edges() const;  // bins() + 1 values
+        std::span<const std::uint64_t> counts() const;
+        std::uint64_t count(size_t bin) const;
+        std::uint64_t underflow() const;
+        std::uint64_t overflow() const;
+        std::uint64_t total() const;  // every value pushed except NaN
+
+        // Index of the bin holding value; throws std::out_of_range outside [front, back] edge
+        size_t bin(double value) const;
+
+    private:
+        enum class Layout { Uniform, Logarithmic, Edges };
+        Histogram(Layout layout, std::vector<double> edges);
+
+        // Number of edges <= value, with the upper edge itself counted in the last bin: 0 is
+        // underflow, 1..bins() the bins and bins() + 1 overflow. NaN gets bins() + 2.
+        size_t slot(double value) const;
+        void locate(const double* values, size_t n, std::int32_t* slots) const;
+        void count_into(std::span<const double> values, std::uint64_t* slots) const;
+
+        Layout m_layout;
+        std::vector<double> m_edges;
+        std::vector<double> m_bounds;  // NaN, edges..., NaN, NaN: slot s lies in [m_bounds[s], m_bounds[s + 1])
+        double m_origin{};  // low, or log2(low) for Logarithmic
+        double m_scale{};   // bins per unit (of log2 for Logarithmic)
+        std::vector<std::uint64_t> m_slots;  // underflow, bins..., overflow
+    };
+
+    Histogram operator+(Histogram lhs, const Histogram& rhs);
+}; // namespace Statistics
+} // namespace imeth
@@ -0,0 +1,68 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <span>
+#include <vector>
+
+namespace imeth {
+namespace NumberTheory {
+    // Deterministic for every 64-bit n: small n are looked up in a cached sieve, the rest go
+    // through trial division by a few small primes and Miller-Rabin with seven fixed bases
+    // (Montgomery multiplication, no 128-bit division).
+    bool is_prime(std::uint64_t n);
+
+    // Stein's binary GCD: shifts by the trailing zero count and subtracts, no division.
+    // gcd(0, 0) is 0.
+    std::uint64_t gcd(std::uint64_t a, std::uint64_t b);
+    // Throws std::overflow_error if the result does not fit in 64 bits; lcm(0, x) is 0
+    std::uint64_t lcm(std::uint64_t a, std::uint64_t b);
+
+    // Reductions over a whole array, split across threads for large inputs. The GCD stops
+    // early once it reaches 1. Empty input gives 0 for gcd and 1 for lcm.
+    std::uint64_t gcd(std::span<const std::uint64_t> values);
+    std::uint64_t lcm(std::span<const std::uint64_t> values);
+    // Element-wise, out[i] = f(a[i], b[i]); all three must have the same size
+    void gcd(std::span<const std::uint64_t> a, std::span<const std::uint64_t> b, std::span<std::uint64_t> out);
+    void lcm(std::span<const std::uint64_t> a, std::span<const std::uint64_t> b, std::span<std::uint64_t> out);
+
+    // Prime factors in ascending order, repeated by multiplicity; factorize(1) is empty and
+    // factorize(0) throws. Small factors are found by trial division, the rest by Pollard's
+    // rho with Brent's cycle detection and batched GCDs (Montgomery arithmetic).
+    std::vector<std::uint64_t> factorize(std::uint64_t n);
+
+    // Segmented sieve of Eratosthenes over odd numbers; multiples of 3, 5, 7, 11 and 13 are
+    // stamped from a precomputed wheel pattern and the remaining primes up to sqrt(high) are
+    // crossed off one cache-sized segment at a time. Segments are sieved in parallel.
+    // Ranges are inclusive, and high must stay below max_sieve_limit (2^50); beyond that use
+    // is_prime on individual numbers.
+    inline constexpr std::uint64_t max_sieve_limit = std::uint64_t{1} << 50;
+
+    std::uint64_t count_primes(std::uint64_t high);  // primes <= high
+    std::uint64_t count_primes(std::uint64_t low, std::uint64_t high);
+    std::vector<std::uint64_t> primes(std::uint64_t high);  // primes <= high, ascending
+    std::vector<std::uint64_t> primes(std::uint64_t low, std::uint64_t high);
+    // Calls fn on every prime in [low, high] in ascending order, on the calling thread;
+    // only a bounded window of segments is held in memory at a time
+    void for_each_prime(std::uint64_t low, std::uint64_t high, const std::function<void(std::uint64_t)>& fn);
+
+    // Packed bit table of the odd primes up to a limit, one bit per odd number (limit / 16
+    // bytes). Lookups are a shift and a mask.
+    class PrimeTable {
+    public:
+        explicit PrimeTable(std::uint64_t limit);
+
+        bool contains(std::uint64_t n) const; // throws std::out_of_range above limit()
+        std::uint64_t limit() const;
+        std::uint64_t count() const;          // primes <= limit
+
+    private:
+        std::uint64_t m_limit;
+        std::uint64_t m_count{};
+        std::vector<std::uint64_t> m_bits;    // bit k stands for 2k + 1
+    };
+
+    // Shared table behind is_prime, built on first use (thread-safe)
+    const PrimeTable& small_primes();
+}; // namespace NumberTheory
+} // namespace imeth
@@ -0,0 +1,68 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <span>
+#include <utility>
+#include <vector>
+
+namespace imeth {
+namespace Statistics {
+    // Approximate quantiles of an unbounded stream in bounded memory (KLL sketch).
+    //
+    // Values land in a buffer; when it fills, it is sorted and every other value (random offset)
+    // moves one level up with twice the weight. Level capacities shrink geometrically towards the
+    // bottom, so about 3k values are retained however long the stream is. Inserts are amortized
+    // O(1) apart from sorting the level-0 buffer once per k/2 or so values.
+    //
+    // Rank error shrinks with k: a quantile query returns a value whose true rank is within
+    // normalized_rank_error() of the requested one (99% confidence), about 1.3% for k = 200.
+    class QuantileSketch {
+    public:
+        explicit QuantileSketch(size_t k = 200);
+
+        void push(double value); // NaN is ignored
+        void push(std::span<const double> values);
+        // Both sketches must use the same k
+        void merge(const QuantileSketch& other);
+        QuantileSketch& operator+=(const QuantileSketch& other);
+        void reset();
+
+        size_t k() const;
+        std::uint64_t count() const;
+        bool empty() const;
+        size_t retained() const;  // values actually held
+        double normalized_rank_error() const;
+
+        double minimum() const;   // exact
+        double maximum() const;   // exact
+        double quantile(double p) const;
+        std::vector<double> quantiles(const std::vector<double>& probabilities) const;
+        double median() const;
+        double rank(double value) const;  // approximate fraction of values <= value
+
+        // Compact little-endian encoding; the layout does not depend on the platform
+        std::vector<std::uint8_t> serialize() const;
+        static QuantileSketch deserialize(std::span<const std::uint8_t> bytes);
+
+    private:
+        void add_level();
+        void compress();
+        void compact(size_t level);
+        // Retained values sorted, paired with their cumulative weight
+        std::vector<std::pair<double, std::uint64_t>> sorted_view() const;
+
+        size_t m_k;
+        std::uint64_t m_count{};
+        double m_min{std::numeric_limits<double>::infinity()};
+        double m_max{-std::numeric_limits<double>::infinity()};
+        std::vector<std::vector<double>> m_levels; // level h holds values of weight 2^h
+        std::vector<size_t> m_level_capacity;      // shrinks by 2/3 per level below the top
+        size_t m_retained{};
+        size_t m_capacity{};  // sum of level capacities; compress when m_retained reaches it
+        std::uint64_t m_random{0x9e3779b97f4a7c15ULL}; // xorshift state for compaction offsets
+    };
+
+    QuantileSketch operator+(QuantileSketch lhs, const QuantileSketch& rhs);
+}; // namespace Statistics
+} // namespace imeth
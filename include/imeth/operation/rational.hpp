@@ -0,0 +1,209 @@
+#pragma once
+#include <compare>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <stdexcept>
+#include <type_traits>
+
+namespace imeth {
+    // Exact fractions over a fixed-width signed integer: Rational<std::int64_t> (Fraction), or
+    // Rational<__int128> (WideFraction) where the compiler has it, for longer chains.
+    //
+    // Results are not reduced as they are computed: a/b + c/d is (ad + cb)/bd, and fractions
+    // with the same denominator, like amounts in cents, add with a single addition. Only when a
+    // product or sum would overflow are the operands reduced by their GCD (Stein's binary GCD,
+    // as in NumberTheory::gcd) and the operation redone on the smaller terms, in lowest terms.
+    // If even that does not fit, the operation throws std::overflow_error; it never wraps or
+    // rounds.
+    //
+    // The denominator is always positive. numerator() and denominator() are the stored terms,
+    // which may share a factor; reduced() gives lowest terms. Comparisons are exact whatever
+    // the representation, so 2/4 == 1/2.
+    namespace detail_rational {
+        template <typename T>
+        inline constexpr bool supported = std::is_same_v<T, std::int64_t>;
+#if defined(__SIZEOF_INT128__)
+        template <>
+        inline constexpr bool supported<__int128> = true;
+#endif
+
+        // Overflow-checked signed arithmetic; true means the result did not fit
+        template <typename T>
+        bool add_overflow(T a, T b, T& out) {
+#if defined(__GNUC__) || defined(__clang__)
+            return __builtin_add_overflow(a, b, &out);
+#else
+            if ((b > 0 && a > INT64_MAX - b) || (b < 0 && a < INT64_MIN - b)) return true;
+            out = a + b;
+            return false;
+#endif
+        }
+
+        template <typename T>
+        bool sub_overflow(T a, T b, T& out) {
+#if defined(__GNUC__) || defined(__clang__)
+            return __builtin_sub_overflow(a, b, &out);
+#else
+            if ((b < 0 && a > INT64_MAX + b) || (b > 0 && a < INT64_MIN + b)) return true;
+            out = a - b;
+            return false;
+#endif
+        }
+
+        template <typename T>
+        bool mul_overflow(T a, T b, T& out) {
+#if defined(__GNUC__) || defined(__clang__)
+            return __builtin_mul_overflow(a, b, &out);
+#else
+            out = 0;
+            if (a == 0 || b == 0) return false;
+            const bool negative = (a < 0) != (b < 0);
+            const std::uint64_t ua = a < 0 ? 0 - static_cast<std::uint64_t>(a) : static_cast<std::uint64_t>(a);
+            const std::uint64_t ub = b < 0 ? 0 - static_cast<std::uint64_t>(b) : static_cast<std::uint64_t>(b);
+            const std::uint64_t limit = static_cast<std::uint64_t>(INT64_MAX) + (negative ? 1 : 0);
+            if (ua > limit / ub) return true;
+            const std::uint64_t p = ua * ub;
+            out = static_cast<T>(negative ? 0 - p : p);
+            return false;
+#endif
+        }
+    } // namespace detail_rational
+
+    template <typename T = std::int64_t>
+    class Rational {
+        static_assert(detail_rational::supported<T>, "Rational supports std::int64_t and __int128");
+
+    public:
+        using value_type = T;
+
+        Rational() = default;  // 0
+        // Throws std::invalid_argument if denominator is 0
+        Rational(T numerator, T denominator = 1) : m_num(numerator), m_den(denominator) {
+            if (denominator == 0) throw std::invalid_argument("Denominator cannot be zero");
+            if (denominator < 0) normalize_sign();
+        }
+        // Widening, e.g. from Fraction to WideFraction
+        template <typename U>
+            requires(sizeof(U) < sizeof(T))
+        Rational(const Rational<U>& other) : m_num(other.numerator()), m_den(other.denominator()) {}
+
+        T numerator() const { return m_num; }
+        T denominator() const { return m_den; }
+        Rational reduced() const;
+        Rational reciprocal() const;  // throws std::invalid_argument for 0
+        double to_double() const { return static_cast<double>(m_num) / static_cast<double>(m_den); }
+        explicit operator double() const { return to_double(); }
+
+        Rational operator-() const {
+            T n;
+            if (!detail_rational::sub_overflow(T{0}, m_num, n)) [[likely]] return Rational(n, m_den, Unchecked{});
+            return Rational(m_num, -m_den);  // reduces -2^63/2 to -2^62, or throws
+        }
+
+        Rational& operator+=(const Rational& other) {
+            T n, d, ad, cb;
+            if (m_den == other.m_den) {
+                if (!detail_rational::add_overflow(m_num, other.m_num, n)) [[likely]] {
+                    m_num = n;
+                    return *this;
+                }
+            } else if (!detail_rational::mul_overflow(m_num, other.m_den, ad) &&
+                       !detail_rational::mul_overflow(other.m_num, m_den, cb) &&
+                       !detail_rational::add_overflow(ad, cb, n) &&
+                       !detail_rational::mul_overflow(m_den, other.m_den, d)) [[likely]] {
+                m_num = n;
+                m_den = d;
+                return *this;
+            }
+            return *this = add_reduced(*this, other, false);
+        }
+
+        Rational& operator-=(const Rational& other) {
+            T n, d, ad, cb;
+            if (m_den == other.m_den) {
+                if (!detail_rational::sub_overflow(m_num, other.m_num, n)) [[likely]] {
+                    m_num = n;
+                    return *this;
+                }
+            } else if (!detail_rational::mul_overflow(m_num, other.m_den, ad) &&
+                       !detail_rational::mul_overflow(other.m_num, m_den, cb) &&
+                       !detail_rational::sub_overflow(ad, cb, n) &&
+                       !detail_rational::mul_overflow(m_den, other.m_den, d)) [[likely]] {
+                m_num = n;
+                m_den = d;
+                return *this;
+            }
+            return *this = add_reduced(*this, other, true);
+        }
+
+        Rational& operator*=(const Rational& other) {
+            T n, d;
+            if (!detail_rational::mul_overflow(m_num, other.m_num, n) &&
+                !detail_rational::mul_overflow(m_den, other.m_den, d)) [[likely]] {
+                m_num = n;
+                m_den = d;
+                return *this;
+            }
+            return *this = multiply_reduced(*this, other);
+        }
+
+        // Throws std::invalid_argument when dividing by 0
+        Rational& operator/=(const Rational& other) {
+            if (other.m_num == 0) throw std::invalid_argument("Cannot divide by zero");
+            T n, d;
+            if (!detail_rational::mul_overflow(m_num, other.m_den, n) &&
+                !detail_rational::mul_overflow(m_den, other.m_num, d) &&
+                (d > 0 || (!detail_rational::sub_overflow(T{0}, n, n) &&
+                           !detail_rational::sub_overflow(T{0}, d, d)))) [[likely]] {
+                m_num = n;
+                m_den = d;
+                return *this;
+            }
+            return *this = divide_reduced(*this, other);
+        }
+
+        friend Rational operator+(Rational a, const Rational& b) { return a += b; }
+        friend Rational operator-(Rational a, const Rational& b) { return a -= b; }
+        friend Rational operator*(Rational a, const Rational& b) { return a *= b; }
+        friend Rational operator/(Rational a, const Rational& b) { return a /= b; }
+
+        friend bool operator==(const Rational& a, const Rational& b) { return (a <=> b) == 0; }
+        friend std::strong_ordering operator<=>(const Rational& a, const Rational& b) {
+            if (a.m_den == b.m_den) return a.m_num <=> b.m_num;
+            T ad, cb;
+            if (!detail_rational::mul_overflow(a.m_num, b.m_den, ad) &&
+                !detail_rational::mul_overflow(b.m_num, a.m_den, cb)) [[likely]]
+                return ad <=> cb;
+            return compare_exact(a, b);
+        }
+
+        // Element-wise out[i] = a[i] op b[i]; all three must have the same size and out may be
+        // a or b. Large arrays are split across threads.
+        static void add(std::span<const Rational> a, std::span<const Rational> b, std::span<Rational> out);
+        static void multiply(std::span<const Rational> a, std::span<const Rational> b, std::span<Rational> out);
+        // Exact sum in lowest terms, 0 for empty input; blocks are summed in parallel and
+        // combined in order
+        static Rational sum(std::span<const Rational> values);
+        // Brings every value to lowest terms, e.g. before printing or hashing
+        static void reduce(std::span<Rational> values);
+
+    private:
+        struct Unchecked {};
+        Rational(T numerator, T denominator, Unchecked) : m_num(numerator), m_den(denominator) {}
+
+        void normalize_sign();
+        static Rational add_reduced(Rational a, Rational b, bool subtract);
+        static Rational multiply_reduced(Rational a, Rational b);
+        static Rational divide_reduced(Rational a, Rational b);
+        static std::strong_ordering compare_exact(Rational a, Rational b);
+
+        T m_num{0};
+        T m_den{1};
+    };
+
+    using Fraction = Rational<std::int64_t>;
+#if defined(__SIZEOF_INT128__)
+    using WideFraction = Rational<__int128>;
+#endif
+} // namespace imeth
@@ -0,0 +1,122 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <set>
+#include <span>
+#include <vector>
+
+namespace imeth {
+namespace Statistics {
+    namespace detail_rolling {
+        // Sum, mean and M2 of a fixed-size window. Welford steps while filling, then one
+        // replace(old, new) per slide; resync() recomputes everything exactly from the window.
+        class Moments {
+        public:
+            void add(double value);
+            void replace(double old, double value);
+            void resync(const double* values, size_t n);
+
+            size_t count() const { return m_count; }
+            double sum() const { return m_sum + m_compensation; }
+            double mean() const { return m_mean; }
+            double m2() const { return m_m2; }
+
+        private:
+            size_t m_count{};
+            double m_mean{};
+            double m_m2{};            // sum of squared deviations from the mean
+            double m_sum{};
+            double m_compensation{};  // Neumaier running error of m_sum
+        };
+
+        // Monotonic queue of (index, value) candidates for the window minimum or maximum, in a
+        // ring buffer of window + 1 slots, so pushes never allocate
+        class ExtremeQueue {
+        public:
+            ExtremeQueue(size_t window, bool largest);
+            void push(std::uint64_t index, double value);
+            double front() const { return m_values[m_head]; }
+
+        private:
+            size_t m_window;
+            bool m_largest;
+            std::vector<std::uint64_t> m_indices;
+            std::vector<double> m_values;
+            size_t m_head{};
+            size_t m_size{};
+        };
+
+        // Lower and upper halves in two multisets; replace() moves tree nodes between them
+        // instead of allocating
+        class MedianHalves {
+        public:
+            void insert(double value);
+            void replace(double old, double value);
+            double median() const;
+
+        private:
+            void rebalance();
+
+            std::multiset<double> m_low;   // holds the extra value when the count is odd
+            std::multiset<double> m_high;
+        };
+    } // namespace detail_rolling
+
+    // Statistics of the last `window` values of a stream. Each push evicts the oldest value once
+    // the window is full and updates everything incrementally:
+    //
+    // sum, mean, variance - windowed Welford update, O(1); re-derived exactly from the buffer
+    //                       every 64 windows so rounding error cannot build up
+    // minimum, maximum    - monotonic queues of candidates, amortized O(1)
+    // median              - two balanced multisets (lower and upper half), O(log window);
+    //                       skipped when constructed with with_median = false
+    //
+    // Queries cover the values currently held, also while the window is still filling.
+    class RollingWindow {
+    public:
+        explicit RollingWindow(size_t window, bool with_median = true);
+
+        void push(double value);  // throws on NaN, which has no place in the order statistics
+        void push(std::span<const double> values);
+        void reset();
+
+        size_t window() const;
+        size_t count() const;  // values held, at most window()
+        bool empty() const;
+        bool full() const;
+
+        double sum() const;
+        double average() const;
+        double variance() const;        // population variance, divides by count
+        double sample_variance() const; // divides by count - 1
+        double standard_deviation() const;
+        double minimum() const;
+        double maximum() const;
+        double median() const;          // throws std::logic_error when not tracked
+
+    private:
+        size_t m_window;
+        bool m_with_median;
+        std::vector<double> m_ring;     // values in arrival order, oldest at m_next once full
+        size_t m_next{};
+        std::uint64_t m_pushed{};       // total pushes, the index of the next value
+
+        detail_rolling::Moments m_moments;
+        detail_rolling::ExtremeQueue m_min;
+        detail_rolling::ExtremeQueue m_max;
+        detail_rolling::MedianHalves m_median;
+    };
+
+    // Batch versions over a whole array: element i is the statistic of values[i, i + window),
+    // so the result has values.size() - window + 1 entries (none if the array is shorter).
+    // Minimum and maximum use the van Herk / Gil-Werman block scan: three comparisons per
+    // value whatever the window size, in loops the compiler vectorizes.
+    std::vector<double> rolling_sum(std::span<const double> values, size_t window);
+    std::vector<double> rolling_average(std::span<const double> values, size_t window);
+    std::vector<double> rolling_variance(std::span<const double> values, size_t window);
+    std::vector<double> rolling_standard_deviation(std::span<const double> values, size_t window);
+    std::vector<double> rolling_minimum(std::span<const double> values, size_t window);
+    std::vector<double> rolling_maximum(std::span<const double> values, size_t window);
+    std::vector<double> rolling_median(std::span<const double> values, size_t window);
+}; // namespace Statistics
+} // namespace imeth
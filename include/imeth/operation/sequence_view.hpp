@@ -0,0 +1,132 @@
+#pragma once
+#include <compare>
+#include <cstddef>
+#include <iterator>
+#include <ranges>
+#include <span>
+
+namespace imeth {
+    // Lazy views over arithmetic and geometric sequences. Terms are computed when read, so a
+    // view of billions of terms costs three integers. Both are random-access, sized ranges and
+    // compose with std::views:
+    //
+    //     for (auto t : ArithmeticSequence(1, 2, 1'000'000'000) | std::views::take(3)) ...
+    //
+    // Terms wrap modulo 2^64 like the unsigned long long they are computed in, matching
+    // Arithmetic::sequence and Combinatorics::Sequences::geometric_sequence.
+    //
+    // fill() writes a run of consecutive terms into a buffer when one is really needed; it
+    // produces several independent lanes at once so the compiler can vectorize the loop.
+    namespace detail_sequence {
+        // Random-access iterator over term(index). It holds a copy of the (three-integer)
+        // sequence rather than a pointer, so iterators outlive the view they came from, and
+        // caches the current term so ++ costs one step of the recurrence.
+        template <typename Sequence>
+        class Iterator {
+        public:
+            using iterator_concept = std::random_access_iterator_tag;
+            using iterator_category = std::random_access_iterator_tag;
+            using value_type = unsigned long long;
+            using difference_type = std::ptrdiff_t;
+
+            Iterator() = default;
+            Iterator(const Sequence& sequence, unsigned long long index)
+                : m_sequence(sequence), m_index(index), m_value(sequence.term(index)) {}
+
+            value_type operator*() const { return m_value; }
+            value_type operator[](difference_type n) const { return m_sequence.term(m_index + n); }
+
+            Iterator& operator++() {
+                ++m_index;
+                m_value = m_sequence.next(m_value);
+                return *this;
+            }
+            Iterator operator++(int) { auto copy = *this; ++*this; return copy; }
+            Iterator& operator--() { return *this -= 1; }
+            Iterator operator--(int) { auto copy = *this; --*this; return copy; }
+            Iterator& operator+=(difference_type n) {
+                m_index += n;
+                m_value = m_sequence.term(m_index);
+                return *this;
+            }
+            Iterator& operator-=(difference_type n) { return *this += -n; }
+
+            friend Iterator operator+(Iterator it, difference_type n) { return it += n; }
+            friend Iterator operator+(difference_type n, Iterator it) { return it += n; }
+            friend Iterator operator-(Iterator it, difference_type n) { return it -= n; }
+            friend difference_type operator-(const Iterator& a, const Iterator& b) {
+                return static_cast<difference_type>(a.m_index - b.m_index);
+            }
+            friend bool operator==(const Iterator& a, const Iterator& b) { return a.m_index == b.m_index; }
+            friend auto operator<=>(const Iterator& a, const Iterator& b) { return a.m_index <=> b.m_index; }
+
+        private:
+            Sequence m_sequence{};
+            unsigned long long m_index{};
+            unsigned long long m_value{};
+        };
+    } // namespace detail_sequence
+
+    // first, first + diff, first + 2 diff, ...
+    class ArithmeticSequence : public std::ranges::view_interface<ArithmeticSequence> {
+    public:
+        using iterator = detail_sequence::Iterator<ArithmeticSequence>;
+
+        ArithmeticSequence() = default;
+        ArithmeticSequence(unsigned long long first, unsigned long long diff, unsigned long long terms)
+            : m_first(first), m_diff(diff), m_terms(terms) {}
+
+        unsigned long long term(unsigned long long index) const { return m_first + index * m_diff; }
+        unsigned long long next(unsigned long long value) const { return value + m_diff; }
+
+        iterator begin() const { return {*this, 0}; }
+        iterator end() const { return {*this, m_terms}; }
+        unsigned long long size() const { return m_terms; }
+
+        // out[j] = term(offset + j); throws std::out_of_range past the last term
+        void fill(unsigned long long offset, std::span<unsigned long long> out) const;
+
+    private:
+        unsigned long long m_first{};
+        unsigned long long m_diff{};
+        unsigned long long m_terms{};
+    };
+
+    // first, first * ratio, first * ratio^2, ...; term(i) costs O(log i) multiplications
+    class GeometricSequence : public std::ranges::view_interface<GeometricSequence> {
+    public:
+        using iterator = detail_sequence::Iterator<GeometricSequence>;
+
+        GeometricSequence() = default;
+        GeometricSequence(unsigned long long first, unsigned long long ratio, unsigned long long terms)
+            : m_first(first), m_ratio(ratio), m_terms(terms) {}
+
+        unsigned long long term(unsigned long long index) const {
+            unsigned long long result = m_first, base = m_ratio;
+            for (; index != 0; index >>= 1) {
+                if (index & 1) result *= base;
+                base *= base;
+            }
+            return result;
+        }
+        unsigned long long next(unsigned long long value) const { return value * m_ratio; }
+
+        iterator begin() const { return {*this, 0}; }
+        iterator end() const { return {*this, m_terms}; }
+        unsigned long long size() const { return m_terms; }
+
+        // out[j] = term(offset + j); throws std::out_of_range past the last term
+        void fill(unsigned long long offset, std::span<unsigned long long> out) const;
+
+    private:
+        unsigned long long m_first{};
+        unsigned long long m_ratio{};
+        unsigned long long m_terms{};
+    };
+} // namespace imeth
+
+// Iterators do not point into the view, so they stay valid after it is gone
+template <>
+inline constexpr bool std::ranges::enable_borrowed_range<imeth::ArithmeticSequence> = true;
+template <>
+inline constexpr bool std::ranges::enable_borrowed_range<imeth::GeometricSequence> = true;
@@ -0,0 +1,93 @@
+#pragma once
+#include <cstddef>
+#include <limits>
+#include <span>
+
+namespace imeth {
+namespace Statistics {
+    // Single-pass accumulator for count, sum, mean, variance, minimum and maximum.
+    // Values can be pushed one at a time from an unbounded stream; accumulators built on
+    // different threads or shards merge into the same result as one accumulator fed everything.
+    class RunningStats {
+    public:
+        RunningStats() = default;
+
+        void push(double value);
+        void push(std::span<const double> values);
+        void merge(const RunningStats& other);
+        RunningStats& operator+=(const RunningStats& other);
+        void reset();
+
+        size_t count() const;
+        bool empty() const;
+        double sum() const;
+        double average() const;
+        double variance() const;        // population variance, divides by count
+        double sample_variance() const; // divides by count - 1
+        double standard_deviation() const;
+        double minimum() const;
+        double maximum() const;
+        double range() const;
+
+    private:
+        size_t m_count{};
+        double m_mean{};
+        double m_m2{};   // sum of squared deviations from the mean
+        double m_sum{};
+        double m_sum_compensation{}; // Neumaier running error of m_sum
+        double m_min{std::numeric_limits<double>::infinity()};
+        double m_max{-std::numeric_limits<double>::infinity()};
+    };
+
+    RunningStats operator+(RunningStats lhs, const RunningStats& rhs);
+
+    // Least-squares line y = slope * x + intercept and its coefficient of determination
+    struct LinearFit {
+        double slope;
+        double intercept;
+        double r_squared;
+    };
+
+    // Single-pass accumulator for paired columns: means, variances and the co-moment
+    // sum((x - mean x)(y - mean y)), from which covariance, correlation and the regression line
+    // follow. Pairs can be pushed one at a time (Welford-style update) or as whole columns, which
+    // are summed by vectorized kernels block by block on all threads. Merging follows Chan et al.,
+    // so sharded accumulators combine into the result of one accumulator fed everything.
+    class RunningCovariance {
+    public:
+        RunningCovariance() = default;
+
+        void push(double x, double y);
+        void push(std::span<const double> xs, std::span<const double> ys);  // equal lengths
+        void merge(const RunningCovariance& other);
+        RunningCovariance& operator+=(const RunningCovariance& other);
+        void reset();
+
+        size_t count() const;
+        bool empty() const;
+        double mean_x() const;
+        double mean_y() const;
+        double variance_x() const;        // population variances, divide by count
+        double variance_y() const;
+        double covariance() const;        // divides by count
+        double sample_covariance() const; // divides by count - 1
+        double correlation() const;       // Pearson r; throws if either column is constant
+        LinearFit fit() const;            // regression of y on x; throws if x is constant
+
+    private:
+        size_t m_count{};
+        double m_mean_x{};
+        double m_mean_y{};
+        double m_m2_x{};   // sum of squared deviations of x from its mean
+        double m_m2_y{};
+        double m_c{};      // co-moment, sum of (x - mean x)(y - mean y)
+    };
+
+    RunningCovariance operator+(RunningCovariance lhs, const RunningCovariance& rhs);
+
+    // One-pass column versions of the RunningCovariance queries
+    double covariance(std::span<const double> xs, std::span<const double> ys);
+    double correlation(std::span<const double> xs, std::span<const double> ys);
+    LinearFit linear_regression(std::span<const double> xs, std::span<const double> ys);
+}; // namespace Statistics
+} // namespace imeth
@@ -0,0 +1,50 @@
+#pragma once
+
+// Runtime instruction-set dispatch shared by the vectorized kernels. On GCC/Clang x86 builds
+// every kernel flavour is compiled with a target attribute and picked by CPU detection;
+// elsewhere the flavour is fixed at compile time by the enabled instruction sets.
+#if (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+#define IMETH_SIMD_DISPATCH 1
+#define IMETH_TARGET(isa) __attribute__((target(isa)))
+#include <immintrin.h>
+#else
+#define IMETH_SIMD_DISPATCH 0
+#define IMETH_TARGET(isa)
+#if defined(__AVX2__) || defined(__AVX512F__)
+#include <immintrin.h>
+#endif
+#endif
+
+#if IMETH_SIMD_DISPATCH || defined(__AVX2__)
+#define IMETH_HAVE_AVX2_KERNELS 1
+#endif
+#if IMETH_SIMD_DISPATCH || defined(__AVX512F__)
+#define IMETH_HAVE_AVX512_KERNELS 1
+#endif
+
+namespace imeth::detail {
+
+enum class Isa { Generic, Avx2, Avx512 };
+
+inline Isa detect_isa() {
+#if IMETH_SIMD_DISPATCH
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx512f")) return Isa::Avx512;
+    if (__builtin_cpu_supports("avx2")) return Isa::Avx2;
+    return Isa::Generic;
+#elif defined(__AVX512F__)
+    return Isa::Avx512;
+#elif defined(__AVX2__)
+    return Isa::Avx2;
+#else
+    return Isa::Generic;
+#endif
+}
+
+// Detected once per process
+inline Isa isa() {
+    static const Isa selected = detect_isa();
+    return selected;
+}
+
+} // namespace imeth::detail
@@ -0,0 +1,237 @@
+#pragma once
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace imeth::detail {
+
+inline unsigned thread_count() {
+    const unsigned n = std::thread::hardware_concurrency();
+    return n == 0 ? 1 : n;
+}
+
+// Worker threads started once and shared by every parallel loop in the library. Starting and
+// joining fresh threads costs tens of microseconds per call, as much as a mid-size GEMM or a
+// QR panel update spends computing, so loops hand their tasks to these instead.
+//
+// run() queues a batch of tasks and then works on it from the calling thread too; idle workers
+// take tasks from the oldest unfinished batch. A task may itself call run(): the caller always
+// makes progress on its own batch, so nested loops cannot deadlock, they just get fewer helpers.
+class ThreadPool {
+public:
+    static ThreadPool& instance() {
+        static ThreadPool pool(thread_count() - 1);
+        return pool;
+    }
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    ~ThreadPool() {
+        {
+            std::lock_guard guard(m_lock);
+            m_stop = true;
+        }
+        m_wake.notify_all();
+        for (auto& t : m_threads) t.join();
+    }
+
+    // Calls task(i) once for every i in [0, count) and returns when all calls have finished.
+    // task must not throw.
+    template <typename Task>
+    void run(size_t count, Task& task) {
+        if (count == 0) return;
+        Batch batch;
+        batch.call = [](void* context, size_t i) { (*static_cast<Task*>(context))(i); };
+        batch.context = &task;
+        batch.count = count;
+
+        std::unique_lock guard(m_lock);
+        m_batches.push_back(&batch);
+        m_wake.notify_all();
+        while (batch.next < batch.count) {
+            const size_t i = claim(batch);
+            guard.unlock();
+            batch.call(batch.context, i);
+            guard.lock();
+            ++batch.finished;
+        }
+        m_done.wait(guard, [&] { return batch.finished == batch.count; });
+    }
+
+private:
+    // Lives on the stack of run(); next and finished are guarded by m_lock, and the batch is
+    // queued only while it has unclaimed tasks
+    struct Batch {
+        void (*call)(void*, size_t){};
+        void* context{};
+        size_t count{};
+        size_t next{};
+        size_t finished{};
+    };
+
+    explicit ThreadPool(unsigned workers) {
+        m_threads.reserve(workers);
+        for (unsigned w = 0; w < workers; ++w)
+            m_threads.emplace_back([this] { work(); });
+    }
+
+    // Takes the next task of batch, with m_lock held; the last one unqueues the batch
+    size_t claim(Batch& batch) {
+        const size_t i = batch.next++;
+        if (batch.next == batch.count) m_batches.erase(std::find(m_batches.begin(), m_batches.end(), &batch));
+        return i;
+    }
+
+    void work() {
+        std::unique_lock guard(m_lock);
+        while (true) {
+            m_wake.wait(guard, [&] { return m_stop || !m_batches.empty(); });
+            if (m_stop) return;
+            Batch& batch = *m_batches.front();
+            const size_t i = claim(batch);
+            guard.unlock();
+            batch.call(batch.context, i);
+            guard.lock();
+            if (++batch.finished == batch.count) m_done.notify_all();
+        }
+    }
+
+    std::mutex m_lock;
+    std::condition_variable m_wake;  // a batch was queued, or the pool is stopping
+    std::condition_variable m_done;  // a batch finished
+    std::deque<Batch*> m_batches;
+    std::vector<std::thread> m_threads;
+    bool m_stop{false};
+};
+
+// Splits [begin, end) into at most thread_count() contiguous chunks of at least `grain`
+// items and runs fn(lo, hi) on each, on the calling thread and the shared ThreadPool. The
+// first exception thrown by any chunk is rethrown after all chunks finish.
+template <typename Fn>
+void parallel_for(size_t begin, size_t end, size_t grain, Fn&& fn) {
+    if (end <= begin) return;
+    const size_t total = end - begin;
+    const size_t chunks = std::min<size_t>(thread_count(), (total + grain - 1) / std::max<size_t>(grain, 1));
+    if (chunks <= 1) {
+        fn(begin, end);
+        return;
+    }
+
+    std::vector<std::exception_ptr> errors(chunks);
+    auto run = [&](size_t c) {
+        const size_t lo = begin + total * c / chunks;
+        const size_t hi = begin + total * (c + 1) / chunks;
+        try {
+            fn(lo, hi);
+        } catch (...) {
+            errors[c] = std::current_exception();
+        }
+    };
+    ThreadPool::instance().run(chunks, run);
+
+    for (const auto& e : errors)
+        if (e) std::rethrow_exception(e);
+}
+
+// Number of workers work_stealing_for() uses for `count` items
+inline unsigned worker_count(size_t count) {
+    return static_cast<unsigned>(std::min<size_t>(thread_count(), std::max<size_t>(count, 1)));
+}
+
+// Runs fn(worker, index) exactly once for every index in [0, count) as `workers` tasks on
+// the shared ThreadPool. Each worker starts with an equal slice; when its slice runs dry it steals the upper half
+// of the largest remaining one, so uneven item costs still balance. `worker` < workers
+// identifies per-worker scratch state. If any call throws, remaining items are skipped
+// and, of the calls that failed, the one with the lowest index has its exception rethrown.
+template <typename Fn>
+void work_stealing_for(size_t count, unsigned workers, Fn&& fn) {
+    if (count == 0) return;
+    workers = std::max(1u, std::min<unsigned>(workers, static_cast<unsigned>(std::min<size_t>(count, ~0u))));
+
+    struct alignas(64) Slice {
+        std::mutex lock;
+        size_t begin{};
+        size_t end{};
+    };
+    const auto slices = std::make_unique<Slice[]>(workers);
+    for (unsigned w = 0; w < workers; ++w) {
+        slices[w].begin = count * w / workers;
+        slices[w].end = count * (w + 1) / workers;
+    }
+
+    std::atomic<bool> failed{false};
+    std::mutex error_lock;
+    size_t error_index = count;
+    std::exception_ptr error;
+
+    auto take = [&](unsigned w, size_t& index) {
+        {
+            std::lock_guard guard(slices[w].lock);
+            if (slices[w].begin < slices[w].end) {
+                index = slices[w].begin++;
+                return true;
+            }
+        }
+        while (!failed.load(std::memory_order_relaxed)) {
+            unsigned victim = workers;
+            size_t most = 0;
+            for (unsigned v = 0; v < workers; ++v) {
+                if (v == w) continue;
+                std::lock_guard guard(slices[v].lock);
+                if (slices[v].end - slices[v].begin > most) {
+                    most = slices[v].end - slices[v].begin;
+                    victim = v;
+                }
+            }
+            if (victim == workers) return false;
+
+            size_t lo, hi;
+            {
+                std::lock_guard guard(slices[victim].lock);
+                const size_t remaining = slices[victim].end - slices[victim].begin;
+                if (remaining == 0) continue;
+                hi = slices[victim].end;
+                lo = slices[victim].begin + remaining / 2;
+                slices[victim].end = lo;
+            }
+            std::lock_guard guard(slices[w].lock);
+            index = lo;
+            slices[w].begin = lo + 1;
+            slices[w].end = hi;
+            return true;
+        }
+        return false;
+    };
+
+    auto run = [&](size_t task) {
+        const auto w = static_cast<unsigned>(task);
+        size_t index;
+        while (take(w, index)) {
+            try {
+                fn(w, index);
+            } catch (...) {
+                std::lock_guard guard(error_lock);
+                if (index < error_index) {
+                    error_index = index;
+                    error = std::current_exception();
+                }
+                failed.store(true, std::memory_order_relaxed);
+            }
+            if (failed.load(std::memory_order_relaxed)) return;
+        }
+    };
+
+    ThreadPool::instance().run(workers, run);
+
+    if (error) std::rethrow_exception(error);
+}
+
+} // namespace imeth::detail
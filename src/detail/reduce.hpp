@@ -0,0 +1,150 @@
+#pragma once
+#include "../include/imeth/operation/arithmetic.hpp"
+#include "parallel.hpp"
+#include "simd.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+// Deterministic parallel reductions over large buffers, with a choice of summation method.
+//
+// The input is cut into fixed BLOCK-element blocks whatever the thread count. Each block is
+// reduced by the simd kernels, and the block sums are combined in a fixed pairwise tree over
+// block indices. Threads only decide who computes which block, never the order of additions,
+// so results are bit-identical for 1 or 128 threads and between serial and parallel runs.
+namespace imeth::detail::reduce {
+
+constexpr size_t BLOCK = size_t{1} << 16;
+// Minimum blocks per thread; below ~1M elements thread start-up costs more than it saves
+constexpr size_t PARALLEL_BLOCKS = 16;
+
+// Fixed-shape pairwise tree: split at n / 2 and recurse
+inline double pairwise_sum(const double* partial, size_t n) {
+    if (n == 1) return partial[0];
+    const size_t half = n / 2;
+    return pairwise_sum(partial, half) + pairwise_sum(partial + half, n - half);
+}
+
+// One Neumaier step: sum + compensation tracks the exact total far longer than sum alone
+inline void neumaier_add(double& sum, double& compensation, double value) {
+    const double t = sum + value;
+    compensation += std::abs(sum) >= std::abs(value) ? (sum - t) + value : (value - t) + sum;
+    sum = t;
+}
+
+// Runs fn(block, lo, hi) once for every block of [0, n), in parallel when there are enough
+template <typename Fn>
+void for_each_block(size_t n, Fn&& fn) {
+    const size_t blocks = (n + BLOCK - 1) / BLOCK;
+    parallel_for(0, blocks, PARALLEL_BLOCKS, [&](size_t b0, size_t b1) {
+        for (size_t b = b0; b < b1; ++b)
+            fn(b, b * BLOCK, std::min(n, (b + 1) * BLOCK));
+    });
+}
+
+enum class Method { Naive, Pairwise, Compensated };
+
+// Arithmetic::Summation to Method by name, so reordering either enum cannot pick the wrong one
+inline Method method_of(const Arithmetic::Summation summation) {
+    switch (summation) {
+    case Arithmetic::Summation::Pairwise: return Method::Pairwise;
+    case Arithmetic::Summation::Neumaier: return Method::Compensated;
+    default: return Method::Naive;
+    }
+}
+
+using Partial = simd::CompensatedSum; // error stays 0 except for Compensated
+
+template <typename T>
+Partial block_sum(const T* data, size_t n, Method method) {
+    switch (method) {
+    case Method::Pairwise: return {simd::sum_pairwise(data, n), 0.0};
+    case Method::Compensated: return simd::sum_compensated(data, n);
+    default: return {simd::sum(data, n), 0.0};
+    }
+}
+
+// Combines partial results in a fixed order: a pairwise tree, or a Neumaier fold that keeps
+// every partial's error term
+inline Partial combine(const Partial* parts, size_t n, Method method) {
+    if (method != Method::Compensated) {
+        std::vector<double> sums(n);
+        for (size_t i = 0; i < n; ++i) sums[i] = parts[i].sum;
+        return {pairwise_sum(sums.data(), n), 0.0};
+    }
+    double s = 0.0, c = 0.0;
+    for (size_t i = 0; i < n; ++i) {
+        neumaier_add(s, c, parts[i].sum);
+        c += parts[i].error;
+    }
+    return {s, c};
+}
+
+template <typename T>
+double sum(const T* data, size_t n, Method method = Method::Naive) {
+    if (n <= BLOCK) {
+        const Partial p = block_sum(data, n, method);
+        return p.sum + p.error;
+    }
+    std::vector<Partial> partial((n + BLOCK - 1) / BLOCK);
+    for_each_block(n, [&](size_t b, size_t lo, size_t hi) { partial[b] = block_sum(data + lo, hi - lo, method); });
+    const Partial total = combine(partial.data(), partial.size(), method);
+    return total.sum + total.error;
+}
+
+// Sum of n generated terms. fill(lo, hi, terms, errors) writes terms[0, hi - lo) and, when
+// errors is not null (Compensated), the exact rounding error of computing each term, e.g.
+// fma(x, y, -x * y) for a product. Terms are produced in L1-sized chunks and never stored whole.
+template <typename Fill>
+double sum_terms(size_t n, Method method, Fill&& fill) {
+    constexpr size_t CHUNK = 512;
+    std::vector<Partial> partial((n + BLOCK - 1) / BLOCK);
+    for_each_block(n, [&](size_t b, size_t lo, size_t hi) {
+        double terms[CHUNK], errors[CHUNK];
+        Partial chunks[BLOCK / CHUNK];
+        size_t count = 0;
+        for (size_t c0 = lo; c0 < hi; c0 += CHUNK) {
+            const size_t len = std::min(CHUNK, hi - c0);
+            fill(c0, c0 + len, terms, method == Method::Compensated ? errors : nullptr);
+            chunks[count] = block_sum(terms, len, method);
+            if (method == Method::Compensated) chunks[count].error += simd::sum(errors, len);
+            ++count;
+        }
+        partial[b] = combine(chunks, count, method);
+    });
+    if (partial.empty()) return 0.0;
+    const Partial total = combine(partial.data(), partial.size(), method);
+    return total.sum + total.error;
+}
+
+template <typename T>
+std::pair<T, T> block_minmax(const T* data, size_t n, bool want_min, bool want_max) {
+    if (want_min && want_max) return simd::minmax(data, n);
+    return {want_min ? simd::min(data, n) : T{}, want_max ? simd::max(data, n) : T{}};
+}
+
+// n must be > 0; returns {min, max}. When both are wanted each block is read once.
+template <typename T>
+std::pair<T, T> minmax(const T* data, size_t n, bool want_min = true, bool want_max = true) {
+    if (n <= BLOCK) return block_minmax(data, n, want_min, want_max);
+    std::vector<std::pair<T, T>> partial((n + BLOCK - 1) / BLOCK);
+    for_each_block(n, [&](size_t b, size_t lo, size_t hi) {
+        partial[b] = block_minmax(data + lo, hi - lo, want_min, want_max);
+    });
+    std::pair<T, T> result = partial[0];
+    for (const auto& [lo, hi] : partial) {
+        result.first = std::min(result.first, lo);
+        result.second = std::max(result.second, hi);
+    }
+    return result;
+}
+
+template <typename T>
+T min(const T* data, size_t n) { return minmax(data, n, true, false).first; }
+
+template <typename T>
+T max(const T* data, size_t n) { return minmax(data, n, false, true).second; }
+
+} // namespace imeth::detail::reduce
@@ -0,0 +1,199 @@
+#include "selection.hpp"
+#include "parallel.hpp"
+#include <algorithm>
+#include <optional>
+#include <random>
+#include <stdexcept>
+#include <thread>
+
+namespace imeth::detail {
+
+namespace {
+
+// Inputs at least this large try the sampling path
+constexpr size_t SAMPLED_SELECTION = 1u << 21;
+constexpr size_t SAMPLE_SIZE = 1u << 16;
+// Margin around each sampled position; at least eight standard deviations of the sample rank
+constexpr size_t SAMPLE_MARGIN = 1024;
+constexpr size_t MAX_BRACKETS = 16;
+constexpr size_t COUNT_BLOCK = 2048;
+// Subranges larger than this are selected on their own thread
+constexpr size_t PARALLEL_SELECTION = 1u << 20;
+
+// Sorted, unique order statistics the probabilities interpolate between
+std::vector<size_t> needed_ranks(size_t n, const std::vector<double>& probabilities) {
+    std::vector<size_t> ranks;
+    for (const double p : probabilities) {
+        const double h = p * static_cast<double>(n - 1);
+        const size_t lo = static_cast<size_t>(h);
+        ranks.push_back(lo);
+        if (lo + 1 < n && h > static_cast<double>(lo)) ranks.push_back(lo + 1);
+    }
+    std::sort(ranks.begin(), ranks.end());
+    ranks.erase(std::unique(ranks.begin(), ranks.end()), ranks.end());
+    return ranks;
+}
+
+std::vector<double> interpolate(size_t n, const std::vector<double>& probabilities,
+                                const std::vector<size_t>& ranks, const std::vector<double>& values) {
+    auto value_at = [&](size_t rank) {
+        return values[std::lower_bound(ranks.begin(), ranks.end(), rank) - ranks.begin()];
+    };
+    std::vector<double> result;
+    result.reserve(probabilities.size());
+    for (const double p : probabilities) {
+        const double h = p * static_cast<double>(n - 1);
+        const size_t lo = static_cast<size_t>(h);
+        double q = value_at(lo);
+        if (lo + 1 < n && h > static_cast<double>(lo))
+            q += (h - static_cast<double>(lo)) * (value_at(lo + 1) - q);
+        result.push_back(q);
+    }
+    return result;
+}
+
+// Selects ranks [rb, re) (absolute ranks, first corresponds to rank `offset`)
+void multi_select(double* first, double* last, size_t offset, const size_t* rb, const size_t* re,
+                  const size_t* rank_base, double* out) {
+    while (rb != re) {
+        const size_t* mid = rb + (re - rb) / 2;
+        double* nth = first + (*mid - offset);
+        std::nth_element(first, nth, last);
+        out[mid - rank_base] = *nth;
+
+        // Left: [first, nth) with ranks < *mid; right: (nth, last) with ranks > *mid
+        if (nth - first > static_cast<std::ptrdiff_t>(PARALLEL_SELECTION) &&
+            last - nth > static_cast<std::ptrdiff_t>(PARALLEL_SELECTION) && rb != mid) {
+            std::thread left(multi_select, first, nth, offset, rb, mid, rank_base, out);
+            multi_select(nth + 1, last, *mid + 1, mid + 1, re, rank_base, out);
+            left.join();
+            return;
+        }
+        multi_select(first, nth, offset, rb, mid, rank_base, out);
+        offset = *mid + 1;
+        first = nth + 1;
+        rb = mid + 1;
+    }
+}
+
+std::optional<std::vector<double>> sampled_select(const double* data, size_t n, const std::vector<size_t>& ranks) {
+    if (n < SAMPLED_SELECTION) return std::nullopt;
+
+    std::mt19937_64 rng(0x9e3779b97f4a7c15ULL);
+    std::uniform_int_distribution<size_t> pick(0, n - 1);
+    std::vector<double> sample(SAMPLE_SIZE);
+    for (double& s : sample) s = data[pick(rng)];
+    std::sort(sample.begin(), sample.end());
+
+    // Value interval around each rank's sampled position; overlapping intervals are merged
+    std::vector<double> lo, hi;
+    std::vector<size_t> bracket_of(ranks.size());
+    size_t last_hi = 0, covered = 0;
+    for (size_t r = 0; r < ranks.size(); ++r) {
+        const size_t pos = static_cast<size_t>(static_cast<double>(ranks[r]) / static_cast<double>(n) * SAMPLE_SIZE);
+        const size_t l = pos > SAMPLE_MARGIN ? pos - SAMPLE_MARGIN : 0;
+        const size_t h = std::min(pos + SAMPLE_MARGIN, SAMPLE_SIZE - 1);
+        if (lo.empty() || l > last_hi) {
+            lo.push_back(sample[l]);
+            hi.push_back(sample[h]);
+            covered += h - l;
+        } else {
+            hi.back() = sample[h];
+            covered += h - last_hi;
+        }
+        last_hi = h;
+        bracket_of[r] = lo.size() - 1;
+    }
+    const size_t brackets = lo.size();
+    // Many brackets, or brackets holding a large share of the data, cost more than a copy
+    if (brackets > MAX_BRACKETS || covered > SAMPLE_SIZE / 8) return std::nullopt;
+
+    // One pass: per chunk, count the values below each bracket and collect the ones inside.
+    // Blocks stay in L1 while every bracket is tested.
+    const size_t chunks = thread_count();
+    std::vector<size_t> below(chunks * brackets, 0);
+    std::vector<std::vector<double>> inside(chunks * brackets);
+    parallel_for(0, chunks, 1, [&](size_t c0, size_t c1) {
+        std::vector<double> staging(COUNT_BLOCK);
+        for (size_t c = c0; c < c1; ++c) {
+            const size_t end = n * (c + 1) / chunks;
+            for (size_t i0 = n * c / chunks; i0 < end; i0 += COUNT_BLOCK) {
+                const size_t i1 = std::min(i0 + COUNT_BLOCK, end);
+                for (size_t b = 0; b < brackets; ++b) {
+                    const double l = lo[b], h = hi[b];
+                    double* out = staging.data();
+                    size_t count = 0, kept = 0;
+                    // Branch-free compaction: every value is stored, only members advance the cursor
+                    for (size_t i = i0; i < i1; ++i) {
+                        const double x = data[i];
+                        count += x < l;
+                        out[kept] = x;
+                        kept += (x >= l) & (x <= h);
+                    }
+                    below[c * brackets + b] += count;
+                    auto& members = inside[c * brackets + b];
+                    members.insert(members.end(), out, out + kept);
+                }
+            }
+        }
+    });
+
+    std::vector<size_t> below_total(brackets, 0);
+    std::vector<std::vector<double>> members(brackets);
+    for (size_t b = 0; b < brackets; ++b)
+        for (size_t c = 0; c < chunks; ++c) {
+            below_total[b] += below[c * brackets + b];
+            const auto& part = inside[c * brackets + b];
+            members[b].insert(members[b].end(), part.begin(), part.end());
+        }
+
+    // Ranks are ascending, so each selection only needs the part of its bracket right of the last
+    std::vector<double> values(ranks.size());
+    std::vector<size_t> selected(brackets, 0);
+    for (size_t r = 0; r < ranks.size(); ++r) {
+        const size_t b = bracket_of[r];
+        auto& m = members[b];
+        if (ranks[r] < below_total[b] || ranks[r] >= below_total[b] + m.size())
+            return std::nullopt; // sample was unlucky (or the data has NaNs)
+        const size_t local = ranks[r] - below_total[b];
+        std::nth_element(m.begin() + selected[b], m.begin() + local, m.end());
+        values[r] = m[local];
+        selected[b] = local;
+    }
+    return values;
+}
+
+} // namespace
+
+void validate_quantile_arguments(size_t n, const std::vector<double>& probabilities) {
+    if (n == 0)
+        throw std::invalid_argument("Cannot find quantile of empty list");
+    for (const double p : probabilities)
+        if (!(p >= 0.0 && p <= 1.0))
+            throw std::invalid_argument("Quantile probability must be in [0, 1]");
+}
+
+std::vector<double> quantiles_in_place(double* data, size_t n, const std::vector<double>& probabilities) {
+    validate_quantile_arguments(n, probabilities);
+    const auto ranks = needed_ranks(n, probabilities);
+    if (auto sampled = sampled_select(data, n, ranks))
+        return interpolate(n, probabilities, ranks, *sampled);
+
+    std::vector<double> values(ranks.size());
+    multi_select(data, data + n, 0, ranks.data(), ranks.data() + ranks.size(), ranks.data(), values.data());
+    return interpolate(n, probabilities, ranks, values);
+}
+
+std::vector<double> quantiles(const double* data, size_t n, const std::vector<double>& probabilities) {
+    validate_quantile_arguments(n, probabilities);
+    const auto ranks = needed_ranks(n, probabilities);
+    if (auto sampled = sampled_select(data, n, ranks))
+        return interpolate(n, probabilities, ranks, *sampled);
+
+    std::vector<double> copy(data, data + n);
+    std::vector<double> values(ranks.size());
+    multi_select(copy.data(), copy.data() + n, 0, ranks.data(), ranks.data() + ranks.size(), ranks.data(), values.data());
+    return interpolate(n, probabilities, ranks, values);
+}
+
+} // namespace imeth::detail
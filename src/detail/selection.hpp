@@ -0,0 +1,23 @@
+#pragma once
+#include <cstddef>
+#include <vector>
+
+// Order-statistic selection shared by the quantile functions. Quantiles interpolate linearly
+// between neighbouring order statistics: h = p * (n - 1), q = x[floor(h)] + frac(h) * (x[floor(h) + 1] - x[floor(h)]),
+// so the 0.5 quantile is the usual median.
+namespace imeth::detail {
+
+// Throws std::invalid_argument for an empty input or a probability outside [0, 1]
+void validate_quantile_arguments(size_t n, const std::vector<double>& probabilities);
+
+// Reorders data. Every requested order statistic is found by one recursive multi-select pass:
+// nth_element on the middle rank splits the problem, and both halves are handled in parallel
+// once they are large enough.
+std::vector<double> quantiles_in_place(double* data, size_t n, const std::vector<double>& probabilities);
+
+// Leaves data untouched. Large inputs avoid a full copy: a random sample brackets each
+// requested rank, one parallel pass counts and gathers the few values inside the brackets,
+// and the exact order statistic is selected from those. Falls back to copy + multi-select.
+std::vector<double> quantiles(const double* data, size_t n, const std::vector<double>& probabilities);
+
+} // namespace imeth::detail
@@ -0,0 +1,588 @@
+#include "simd.hpp"
+#include "isa.hpp"
+#include <algorithm>
+#include <cmath>
+
+namespace imeth::detail::simd {
+
+namespace {
+
+// Adds the tail to lanes 0..tail-1 and folds the 16 lanes pairwise
+template <typename T>
+double fold(double* acc, const T* tail, size_t count) {
+    for (size_t l = 0; l < count; ++l) acc[l] += static_cast<double>(tail[l]);
+    for (size_t width = LANES / 2; width > 0; width /= 2)
+        for (size_t l = 0; l < width; ++l) acc[l] += acc[l + width];
+    return acc[0];
+}
+
+template <typename T>
+double sum_generic(const T* x, size_t n) {
+    double acc[LANES] = {};
+    size_t i = 0;
+    for (; i + LANES <= n; i += LANES)
+        for (size_t l = 0; l < LANES; ++l) acc[l] += static_cast<double>(x[i + l]);
+    return fold(acc, x + i, n - i);
+}
+
+// Neumaier step: the error of s + x is exact whichever operand is larger in magnitude
+inline void neumaier_add(double& s, double& c, double x) {
+    const double t = s + x;
+    if (std::abs(s) >= std::abs(x))
+        c += (s - t) + x;
+    else
+        c += (x - t) + s;
+    s = t;
+}
+
+// Compensated counterpart of fold(): tail into lanes 0..tail-1, then a pairwise lane fold
+template <typename T>
+CompensatedSum fold_compensated(double* s, double* c, const T* tail, size_t count) {
+    for (size_t l = 0; l < count; ++l) neumaier_add(s[l], c[l], static_cast<double>(tail[l]));
+    for (size_t width = LANES / 2; width > 0; width /= 2)
+        for (size_t l = 0; l < width; ++l) {
+            neumaier_add(s[l], c[l], s[l + width]);
+            c[l] += c[l + width];
+        }
+    return {s[0], c[0]};
+}
+
+template <typename T>
+CompensatedSum sum_compensated_generic(const T* x, size_t n) {
+    double s[LANES] = {}, c[LANES] = {};
+    size_t i = 0;
+    for (; i + LANES <= n; i += LANES)
+        for (size_t l = 0; l < LANES; ++l) neumaier_add(s[l], c[l], static_cast<double>(x[i + l]));
+    return fold_compensated(s, c, x + i, n - i);
+}
+
+// Every lane starts at x[0] and keeps its value when compared with NaN, so NaN only shows in
+// the result when x[0] is NaN. The AVX2 kernels put the new element first in _mm256_min_pd
+// and _mm256_max_pd, which return the second operand for NaN, to get the same result.
+template <typename T>
+T min_generic(const T* x, size_t n) {
+    T acc[LANES];
+    std::fill(acc, acc + LANES, x[0]);
+    size_t i = 0;
+    for (; i + LANES <= n; i += LANES)
+        for (size_t l = 0; l < LANES; ++l) acc[l] = x[i + l] < acc[l] ? x[i + l] : acc[l];
+    for (; i < n; ++i) acc[0] = x[i] < acc[0] ? x[i] : acc[0];
+    return *std::min_element(acc, acc + LANES);
+}
+
+template <typename T>
+T max_generic(const T* x, size_t n) {
+    T acc[LANES];
+    std::fill(acc, acc + LANES, x[0]);
+    size_t i = 0;
+    for (; i + LANES <= n; i += LANES)
+        for (size_t l = 0; l < LANES; ++l) acc[l] = x[i + l] > acc[l] ? x[i + l] : acc[l];
+    for (; i < n; ++i) acc[0] = x[i] > acc[0] ? x[i] : acc[0];
+    return *std::max_element(acc, acc + LANES);
+}
+
+// min_generic and max_generic in one pass, with the same comparisons
+template <typename T>
+std::pair<T, T> minmax_generic(const T* x, size_t n) {
+    T lo[LANES], hi[LANES];
+    std::fill(lo, lo + LANES, x[0]);
+    std::fill(hi, hi + LANES, x[0]);
+    size_t i = 0;
+    for (; i + LANES <= n; i += LANES)
+        for (size_t l = 0; l < LANES; ++l) {
+            lo[l] = x[i + l] < lo[l] ? x[i + l] : lo[l];
+            hi[l] = x[i + l] > hi[l] ? x[i + l] : hi[l];
+        }
+    for (; i < n; ++i) {
+        lo[0] = x[i] < lo[0] ? x[i] : lo[0];
+        hi[0] = x[i] > hi[0] ? x[i] : hi[0];
+    }
+    return {*std::min_element(lo, lo + LANES), *std::max_element(hi, hi + LANES)};
+}
+
+// acc[k][l] holds lane l of dx, dy, dxx, dyy, dxy (k = 0..4)
+using CoLanes = double[5][CO_LANES];
+
+inline void co_accumulate(CoLanes& acc, size_t l, double x, double y, double shift_x, double shift_y) {
+    const double dx = x - shift_x, dy = y - shift_y;
+    acc[0][l] += dx;
+    acc[1][l] += dy;
+    acc[2][l] += dx * dx;
+    acc[3][l] += dy * dy;
+    acc[4][l] += dx * dy;
+}
+
+// Tail into lanes 0..count-1, then a pairwise lane fold of each sum
+CoMoments fold_co(CoLanes& acc, const double* x, const double* y, size_t count, double shift_x, double shift_y) {
+    for (size_t l = 0; l < count; ++l) co_accumulate(acc, l, x[l], y[l], shift_x, shift_y);
+    double total[5];
+    for (size_t k = 0; k < 5; ++k) {
+        for (size_t width = CO_LANES / 2; width > 0; width /= 2)
+            for (size_t l = 0; l < width; ++l) acc[k][l] += acc[k][l + width];
+        total[k] = acc[k][0];
+    }
+    return {total[0], total[1], total[2], total[3], total[4]};
+}
+
+CoMoments co_moments_generic(const double* x, const double* y, size_t n, double shift_x, double shift_y) {
+    CoLanes acc = {};
+    size_t i = 0;
+    for (; i + CO_LANES <= n; i += CO_LANES)
+        for (size_t l = 0; l < CO_LANES; ++l) co_accumulate(acc, l, x[i + l], y[i + l], shift_x, shift_y);
+    return fold_co(acc, x + i, y + i, n - i, shift_x, shift_y);
+}
+
+#ifdef IMETH_HAVE_AVX2_KERNELS
+
+IMETH_TARGET("avx2") double sum_avx2(const double* x, size_t n) {
+    __m256d a0 = _mm256_setzero_pd(), a1 = a0, a2 = a0, a3 = a0;
+    size_t i = 0;
+    for (; i + LANES <= n; i += LANES) {
+        a0 = _mm256_add_pd(a0, _mm256_loadu_pd(x + i));
+        a1 = _mm256_add_pd(a1, _mm256_loadu_pd(x + i + 4));
+        a2 = _mm256_add_pd(a2, _mm256_loadu_pd(x + i + 8));
+        a3 = _mm256_add_pd(a3, _mm256_loadu_pd(x + i + 12));
+    }
+    alignas(32) double acc[LANES];
+    _mm256_store_pd(acc, a0);
+    _mm256_store_pd(acc + 4, a1);
+    _mm256_store_pd(acc + 8, a2);
+    _mm256_store_pd(acc + 12, a3);
+    return fold(acc, x + i, n - i);
+}
+
+IMETH_TARGET("avx2") double sum_avx2(const float* x, size_t n) {
+    __m256d a0 = _mm256_setzero_pd(), a1 = a0, a2 = a0, a3 = a0;
+    size_t i = 0;
+    for (; i + LANES <= n; i += LANES) {
+        a0 = _mm256_add_pd(a0, _mm256_cvtps_pd(_mm_loadu_ps(x + i)));
+        a1 = _mm256_add_pd(a1, _mm256_cvtps_pd(_mm_loadu_ps(x + i + 4)));
+        a2 = _mm256_add_pd(a2, _mm256_cvtps_pd(_mm_loadu_ps(x + i + 8)));
+        a3 = _mm256_add_pd(a3, _mm256_cvtps_pd(_mm_loadu_ps(x + i + 12)));
+    }
+    alignas(32) double acc[LANES];
+    _mm256_store_pd(acc, a0);
+    _mm256_store_pd(acc + 4, a1);
+    _mm256_store_pd(acc + 8, a2);
+    _mm256_store_pd(acc + 12, a3);
+    return fold(acc, x + i, n - i);
+}
+
+IMETH_TARGET("avx2") double min_avx2(const double* x, size_t n) {
+    if (n < LANES) return min_generic(x, n);
+    __m256d a0 = _mm256_set1_pd(x[0]), a1 = a0, a2 = a0, a3 = a0;
+    size_t i = 0;
+    for (; i + LANES <= n; i += LANES) {
+        a0 = _mm256_min_pd(_mm256_loadu_pd(x + i), a0);
+        a1 = _mm256_min_pd(_mm256_loadu_pd(x + i + 4), a1);
+        a2 = _mm256_min_pd(_mm256_loadu_pd(x + i + 8), a2);
+        a3 = _mm256_min_pd(_mm256_loadu_pd(x + i + 12), a3);
+    }
+    alignas(32) double acc[LANES];
+    _mm256_store_pd(acc, _mm256_min_pd(_mm256_min_pd(a0, a1), _mm256_min_pd(a2, a3)));
+    double result = *std::min_element(acc, acc + 4);
+    for (; i < n; ++i) result = x[i] < result ? x[i] : result;
+    return result;
+}
+
+IMETH_TARGET("avx2") double max_avx2(const double* x, size_t n) {
+    if (n < LANES) return max_generic(x, n);
+    __m256d a0 = _mm256_set1_pd(x[0]), a1 = a0, a2 = a0, a3 = a0;
+    size_t i = 0;
+    for (; i + LANES <= n; i += LANES) {
+        a0 = _mm256_max_pd(_mm256_loadu_pd(x + i), a0);
+        a1 = _mm256_max_pd(_mm256_loadu_pd(x + i + 4), a1);
+        a2 = _mm256_max_pd(_mm256_loadu_pd(x + i + 8), a2);
+        a3 = _mm256_max_pd(_mm256_loadu_pd(x + i + 12), a3);
+    }
+    alignas(32) double acc[LANES];
+    _mm256_store_pd(acc, _mm256_max_pd(_mm256_max_pd(a0, a1), _mm256_max_pd(a2, a3)));
+    double result = *std::max_element(acc, acc + 4);
+    for (; i < n; ++i) result = x[i] > result ? x[i] : result;
+    return result;
+}
+
+IMETH_TARGET("avx2") float min_avx2(const float* x, size_t n) {
+    if (n < 2 * LANES) return min_generic(x, n);
+    __m256 a0 = _mm256_set1_ps(x[0]), a1 = a0, a2 = a0, a3 = a0;
+    size_t i = 0;
+    for (; i + 2 * LANES <= n; i += 2 * LANES) {
+        a0 = _mm256_min_ps(_mm256_loadu_ps(x + i), a0);
+        a1 = _mm256_min_ps(_mm256_loadu_ps(x + i + 8), a1);
+        a2 = _mm256_min_ps(_mm256_loadu_ps(x + i + 16), a2);
+        a3 = _mm256_min_ps(_mm256_loadu_ps(x + i + 24), a3);
+    }
+    alignas(32) float acc[8];
+    _mm256_store_ps(acc, _mm256_min_ps(_mm256_min_ps(a0, a1), _mm256_min_ps(a2, a3)));
+    float result = *std::min_element(acc, acc + 8);
+    for (; i < n; ++i) result = x[i] < result ? x[i] : result;
+    return result;
+}
+
+IMETH_TARGET("avx2") float max_avx2(const float* x, size_t n) {
+    if (n < 2 * LANES) return max_generic(x, n);
+    __m256 a0 = _mm256_set1_ps(x[0]), a1 = a0, a2 = a0, a3 = a0;
+    size_t i = 0;
+    for (; i + 2 * LANES <= n; i += 2 * LANES) {
+        a0 = _mm256_max_ps(_mm256_loadu_ps(x + i), a0);
+        a1 = _mm256_max_ps(_mm256_loadu_ps(x + i + 8), a1);
+        a2 = _mm256_max_ps(_mm256_loadu_ps(x + i + 16), a2);
+        a3 = _mm256_max_ps(_mm256_loadu_ps(x + i + 24), a3);
+    }
+    alignas(32) float acc[8];
+    _mm256_store_ps(acc, _mm256_max_ps(_mm256_max_ps(a0, a1), _mm256_max_ps(a2, a3)));
+    float result = *std::max_element(acc, acc + 8);
+    for (; i < n; ++i) result = x[i] > result ? x[i] : result;
+    return result;
+}
+
+// min_avx2 and max_avx2 in one pass over the data
+IMETH_TARGET("avx2") std::pair<double, double> minmax_avx2(const double* x, size_t n) {
+    if (n < LANES) return minmax_generic(x, n);
+    __m256d l0 = _mm256_set1_pd(x[0]), l1 = l0, l2 = l0, l3 = l0;
+    __m256d h0 = l0, h1 = l0, h2 = l0, h3 = l0;
+    size_t i = 0;
+    for (; i + LANES <= n; i += LANES) {
+        const __m256d v0 = _mm256_loadu_pd(x + i), v1 = _mm256_loadu_pd(x + i + 4);
+        const __m256d v2 = _mm256_loadu_pd(x + i + 8), v3 = _mm256_loadu_pd(x + i + 12);
+        l0 = _mm256_min_pd(v0, l0);
+        l1 = _mm256_min_pd(v1, l1);
+        l2 = _mm256_min_pd(v2, l2);
+        l3 = _mm256_min_pd(v3, l3);
+        h0 = _mm256_max_pd(v0, h0);
+        h1 = _mm256_max_pd(v1, h1);
+        h2 = _mm256_max_pd(v2, h2);
+        h3 = _mm256_max_pd(v3, h3);
+    }
+    alignas(32) double lo[4], hi[4];
+    _mm256_store_pd(lo, _mm256_min_pd(_mm256_min_pd(l0, l1), _mm256_min_pd(l2, l3)));
+    _mm256_store_pd(hi, _mm256_max_pd(_mm256_max_pd(h0, h1), _mm256_max_pd(h2, h3)));
+    double min = *std::min_element(lo, lo + 4), max = *std::max_element(hi, hi + 4);
+    for (; i < n; ++i) {
+        min = x[i] < min ? x[i] : min;
+        max = x[i] > max ? x[i] : max;
+    }
+    return {min, max};
+}
+
+IMETH_TARGET("avx2") std::pair<float, float> minmax_avx2(const float* x, size_t n) {
+    if (n < 2 * LANES) return minmax_generic(x, n);
+    __m256 l0 = _mm256_set1_ps(x[0]), l1 = l0, l2 = l0, l3 = l0;
+    __m256 h0 = l0, h1 = l0, h2 = l0, h3 = l0;
+    size_t i = 0;
+    for (; i + 2 * LANES <= n; i += 2 * LANES) {
+        const __m256 v0 = _mm256_loadu_ps(x + i), v1 = _mm256_loadu_ps(x + i + 8);
+        const __m256 v2 = _mm256_loadu_ps(x + i + 16), v3 = _mm256_loadu_ps(x + i + 24);
+        l0 = _mm256_min_ps(v0, l0);
+        l1 = _mm256_min_ps(v1, l1);
+        l2 = _mm256_min_ps(v2, l2);
+        l3 = _mm256_min_ps(v3, l3);
+        h0 = _mm256_max_ps(v0, h0);
+        h1 = _mm256_max_ps(v1, h1);
+        h2 = _mm256_max_ps(v2, h2);
+        h3 = _mm256_max_ps(v3, h3);
+    }
+    alignas(32) float lo[8], hi[8];
+    _mm256_store_ps(lo, _mm256_min_ps(_mm256_min_ps(l0, l1), _mm256_min_ps(l2, l3)));
+    _mm256_store_ps(hi, _mm256_max_ps(_mm256_max_ps(h0, h1), _mm256_max_ps(h2, h3)));
+    float min = *std::min_element(lo, lo + 8), max = *std::max_element(hi, hi + 8);
+    for (; i < n; ++i) {
+        min = x[i] < min ? x[i] : min;
+        max = x[i] > max ? x[i] : max;
+    }
+    return {min, max};
+}
+
+// One Neumaier step on four lanes; the larger-magnitude operand is picked branch-free
+IMETH_TARGET("avx2") inline void neumaier_avx2(__m256d& s, __m256d& c, __m256d x) {
+    const __m256d sign = _mm256_set1_pd(-0.0);
+    const __m256d t = _mm256_add_pd(s, x);
+    const __m256d s_larger = _mm256_cmp_pd(_mm256_andnot_pd(sign, s), _mm256_andnot_pd(sign, x), _CMP_GE_OQ);
+    const __m256d big = _mm256_blendv_pd(x, s, s_larger);
+    const __m256d small = _mm256_blendv_pd(s, x, s_larger);
+    c = _mm256_add_pd(c, _mm256_add_pd(_mm256_sub_pd(big, t), small));
+    s = t;
+}
+
+IMETH_TARGET("avx2") CompensatedSum sum_compensated_avx2(const double* x, size_t n) {
+    __m256d s0 = _mm256_setzero_pd(), s1 = s0, s2 = s0, s3 = s0;
+    __m256d c0 = s0, c1 = s0, c2 = s0, c3 = s0;
+    size_t i = 0;
+    for (; i + LANES <= n; i += LANES) {
+        neumaier_avx2(s0, c0, _mm256_loadu_pd(x + i));
+        neumaier_avx2(s1, c1, _mm256_loadu_pd(x + i + 4));
+        neumaier_avx2(s2, c2, _mm256_loadu_pd(x + i + 8));
+        neumaier_avx2(s3, c3, _mm256_loadu_pd(x + i + 12));
+    }
+    alignas(32) double s[LANES], c[LANES];
+    _mm256_store_pd(s, s0);
+    _mm256_store_pd(s + 4, s1);
+    _mm256_store_pd(s + 8, s2);
+    _mm256_store_pd(s + 12, s3);
+    _mm256_store_pd(c, c0);
+    _mm256_store_pd(c + 4, c1);
+    _mm256_store_pd(c + 8, c2);
+    _mm256_store_pd(c + 12, c3);
+    return fold_compensated(s, c, x + i, n - i);
+}
+
+IMETH_TARGET("avx2") CompensatedSum sum_compensated_avx2(const float* x, size_t n) {
+    __m256d s0 = _mm256_setzero_pd(), s1 = s0, s2 = s0, s3 = s0;
+    __m256d c0 = s0, c1 = s0, c2 = s0, c3 = s0;
+    size_t i = 0;
+    for (; i + LANES <= n; i += LANES) {
+        neumaier_avx2(s0, c0, _mm256_cvtps_pd(_mm_loadu_ps(x + i)));
+        neumaier_avx2(s1, c1, _mm256_cvtps_pd(_mm_loadu_ps(x + i + 4)));
+        neumaier_avx2(s2, c2, _mm256_cvtps_pd(_mm_loadu_ps(x + i + 8)));
+        neumaier_avx2(s3, c3, _mm256_cvtps_pd(_mm_loadu_ps(x + i + 12)));
+    }
+    alignas(32) double s[LANES], c[LANES];
+    _mm256_store_pd(s, s0);
+    _mm256_store_pd(s + 4, s1);
+    _mm256_store_pd(s + 8, s2);
+    _mm256_store_pd(s + 12, s3);
+    _mm256_store_pd(c, c0);
+    _mm256_store_pd(c + 4, c1);
+    _mm256_store_pd(c + 8, c2);
+    _mm256_store_pd(c + 12, c3);
+    return fold_compensated(s, c, x + i, n - i);
+}
+
+IMETH_TARGET("avx2") CoMoments co_moments_avx2(const double* x, const double* y, size_t n, double shift_x,
+                                                double shift_y) {
+    const __m256d sx = _mm256_set1_pd(shift_x), sy = _mm256_set1_pd(shift_y);
+    __m256d a[5][2];
+    for (auto& pair : a) pair[0] = pair[1] = _mm256_setzero_pd();
+    size_t i = 0;
+    for (; i + CO_LANES <= n; i += CO_LANES)
+        for (size_t h = 0; h < 2; ++h) {
+            const __m256d dx = _mm256_sub_pd(_mm256_loadu_pd(x + i + 4 * h), sx);
+            const __m256d dy = _mm256_sub_pd(_mm256_loadu_pd(y + i + 4 * h), sy);
+            a[0][h] = _mm256_add_pd(a[0][h], dx);
+            a[1][h] = _mm256_add_pd(a[1][h], dy);
+            a[2][h] = _mm256_add_pd(a[2][h], _mm256_mul_pd(dx, dx));
+            a[3][h] = _mm256_add_pd(a[3][h], _mm256_mul_pd(dy, dy));
+            a[4][h] = _mm256_add_pd(a[4][h], _mm256_mul_pd(dx, dy));
+        }
+    alignas(32) CoLanes acc;
+    for (size_t k = 0; k < 5; ++k) {
+        _mm256_store_pd(acc[k], a[k][0]);
+        _mm256_store_pd(acc[k] + 4, a[k][1]);
+    }
+    return fold_co(acc, x + i, y + i, n - i, shift_x, shift_y);
+}
+
+#endif
+
+#ifdef IMETH_HAVE_AVX512_KERNELS
+
+IMETH_TARGET("avx512f") double sum_avx512(const double* x, size_t n) {
+    __m512d a0 = _mm512_setzero_pd(), a1 = a0;
+    size_t i = 0;
+    for (; i + LANES <= n; i += LANES) {
+        a0 = _mm512_add_pd(a0, _mm512_loadu_pd(x + i));
+        a1 = _mm512_add_pd(a1, _mm512_loadu_pd(x + i + 8));
+    }
+    alignas(64) double acc[LANES];
+    _mm512_store_pd(acc, a0);
+    _mm512_store_pd(acc + 8, a1);
+    return fold(acc, x + i, n - i);
+}
+
+IMETH_TARGET("avx512f") double sum_avx512(const float* x, size_t n) {
+    __m512d a0 = _mm512_setzero_pd(), a1 = a0;
+    size_t i = 0;
+    for (; i + LANES <= n; i += LANES) {
+        a0 = _mm512_add_pd(a0, _mm512_cvtps_pd(_mm256_loadu_ps(x + i)));
+        a1 = _mm512_add_pd(a1, _mm512_cvtps_pd(_mm256_loadu_ps(x + i + 8)));
+    }
+    alignas(64) double acc[LANES];
+    _mm512_store_pd(acc, a0);
+    _mm512_store_pd(acc + 8, a1);
+    return fold(acc, x + i, n - i);
+}
+
+IMETH_TARGET("avx512f") inline void neumaier_avx512(__m512d& s, __m512d& c, __m512d x) {
+    const __m512d t = _mm512_add_pd(s, x);
+    const __mmask8 s_larger = _mm512_cmp_pd_mask(_mm512_abs_pd(s), _mm512_abs_pd(x), _CMP_GE_OQ);
+    const __m512d big = _mm512_mask_blend_pd(s_larger, x, s);
+    const __m512d small = _mm512_mask_blend_pd(s_larger, s, x);
+    c = _mm512_add_pd(c, _mm512_add_pd(_mm512_sub_pd(big, t), small));
+    s = t;
+}
+
+IMETH_TARGET("avx512f") CompensatedSum sum_compensated_avx512(const double* x, size_t n) {
+    __m512d s0 = _mm512_setzero_pd(), s1 = s0, c0 = s0, c1 = s0;
+    size_t i = 0;
+    for (; i + LANES <= n; i += LANES) {
+        neumaier_avx512(s0, c0, _mm512_loadu_pd(x + i));
+        neumaier_avx512(s1, c1, _mm512_loadu_pd(x + i + 8));
+    }
+    alignas(64) double s[LANES], c[LANES];
+    _mm512_store_pd(s, s0);
+    _mm512_store_pd(s + 8, s1);
+    _mm512_store_pd(c, c0);
+    _mm512_store_pd(c + 8, c1);
+    return fold_compensated(s, c, x + i, n - i);
+}
+
+IMETH_TARGET("avx512f") CompensatedSum sum_compensated_avx512(const float* x, size_t n) {
+    __m512d s0 = _mm512_setzero_pd(), s1 = s0, c0 = s0, c1 = s0;
+    size_t i = 0;
+    for (; i + LANES <= n; i += LANES) {
+        neumaier_avx512(s0, c0, _mm512_cvtps_pd(_mm256_loadu_ps(x + i)));
+        neumaier_avx512(s1, c1, _mm512_cvtps_pd(_mm256_loadu_ps(x + i + 8)));
+    }
+    alignas(64) double s[LANES], c[LANES];
+    _mm512_store_pd(s, s0);
+    _mm512_store_pd(s + 8, s1);
+    _mm512_store_pd(c, c0);
+    _mm512_store_pd(c + 8, c1);
+    return fold_compensated(s, c, x + i, n - i);
+}
+
+IMETH_TARGET("avx512f") CoMoments co_moments_avx512(const double* x, const double* y, size_t n, double shift_x,
+                                                     double shift_y) {
+    const __m512d sx = _mm512_set1_pd(shift_x), sy = _mm512_set1_pd(shift_y);
+    __m512d a0 = _mm512_setzero_pd(), a1 = a0, a2 = a0, a3 = a0, a4 = a0;
+    size_t i = 0;
+    for (; i + CO_LANES <= n; i += CO_LANES) {
+        const __m512d dx = _mm512_sub_pd(_mm512_loadu_pd(x + i), sx);
+        const __m512d dy = _mm512_sub_pd(_mm512_loadu_pd(y + i), sy);
+        a0 = _mm512_add_pd(a0, dx);
+        a1 = _mm512_add_pd(a1, dy);
+        a2 = _mm512_add_pd(a2, _mm512_mul_pd(dx, dx));
+        a3 = _mm512_add_pd(a3, _mm512_mul_pd(dy, dy));
+        a4 = _mm512_add_pd(a4, _mm512_mul_pd(dx, dy));
+    }
+    alignas(64) CoLanes acc;
+    _mm512_store_pd(acc[0], a0);
+    _mm512_store_pd(acc[1], a1);
+    _mm512_store_pd(acc[2], a2);
+    _mm512_store_pd(acc[3], a3);
+    _mm512_store_pd(acc[4], a4);
+    return fold_co(acc, x + i, y + i, n - i, shift_x, shift_y);
+}
+
+#endif
+
+} // namespace
+
+double sum(const double* data, size_t n) {
+#ifdef IMETH_HAVE_AVX512_KERNELS
+    if (isa() == Isa::Avx512) return sum_avx512(data, n);
+#endif
+#ifdef IMETH_HAVE_AVX2_KERNELS
+    if (isa() != Isa::Generic) return sum_avx2(data, n);
+#endif
+    return sum_generic(data, n);
+}
+
+double sum(const float* data, size_t n) {
+#ifdef IMETH_HAVE_AVX512_KERNELS
+    if (isa() == Isa::Avx512) return sum_avx512(data, n);
+#endif
+#ifdef IMETH_HAVE_AVX2_KERNELS
+    if (isa() != Isa::Generic) return sum_avx2(data, n);
+#endif
+    return sum_generic(data, n);
+}
+
+namespace {
+
+constexpr size_t PAIRWISE_LEAF = 256;
+
+template <typename T>
+double pairwise(const T* data, size_t n) {
+    if (n <= PAIRWISE_LEAF) return sum(data, n);
+    const size_t half = n / 2;
+    return pairwise(data, half) + pairwise(data + half, n - half);
+}
+
+} // namespace
+
+double sum_pairwise(const double* data, size_t n) { return pairwise(data, n); }
+double sum_pairwise(const float* data, size_t n) { return pairwise(data, n); }
+
+CompensatedSum sum_compensated(const double* data, size_t n) {
+#ifdef IMETH_HAVE_AVX512_KERNELS
+    if (isa() == Isa::Avx512) return sum_compensated_avx512(data, n);
+#endif
+#ifdef IMETH_HAVE_AVX2_KERNELS
+    if (isa() != Isa::Generic) return sum_compensated_avx2(data, n);
+#endif
+    return sum_compensated_generic(data, n);
+}
+
+CompensatedSum sum_compensated(const float* data, size_t n) {
+#ifdef IMETH_HAVE_AVX512_KERNELS
+    if (isa() == Isa::Avx512) return sum_compensated_avx512(data, n);
+#endif
+#ifdef IMETH_HAVE_AVX2_KERNELS
+    if (isa() != Isa::Generic) return sum_compensated_avx2(data, n);
+#endif
+    return sum_compensated_generic(data, n);
+}
+
+CoMoments co_moments(const double* x, const double* y, size_t n, double shift_x, double shift_y) {
+#ifdef IMETH_HAVE_AVX512_KERNELS
+    if (isa() == Isa::Avx512) return co_moments_avx512(x, y, n, shift_x, shift_y);
+#endif
+#ifdef IMETH_HAVE_AVX2_KERNELS
+    if (isa() != Isa::Generic) return co_moments_avx2(x, y, n, shift_x, shift_y);
+#endif
+    return co_moments_generic(x, y, n, shift_x, shift_y);
+}
+
+// Min/max are bandwidth bound already at AVX2 width, so AVX-512 machines use the AVX2 kernels
+double min(const double* data, size_t n) {
+#ifdef IMETH_HAVE_AVX2_KERNELS
+    if (isa() != Isa::Generic) return min_avx2(data, n);
+#endif
+    return min_generic(data, n);
+}
+
+float min(const float* data, size_t n) {
+#ifdef IMETH_HAVE_AVX2_KERNELS
+    if (isa() != Isa::Generic) return min_avx2(data, n);
+#endif
+    return min_generic(data, n);
+}
+
+double max(const double* data, size_t n) {
+#ifdef IMETH_HAVE_AVX2_KERNELS
+    if (isa() != Isa::Generic) return max_avx2(data, n);
+#endif
+    return max_generic(data, n);
+}
+
+float max(const float* data, size_t n) {
+#ifdef IMETH_HAVE_AVX2_KERNELS
+    if (isa() != Isa::Generic) return max_avx2(data, n);
+#endif
+    return max_generic(data, n);
+}
+
+std::pair<double, double> minmax(const double* data, size_t n) {
+#ifdef IMETH_HAVE_AVX2_KERNELS
+    if (isa() != Isa::Generic) return minmax_avx2(data, n);
+#endif
+    return minmax_generic(data, n);
+}
+
+std::pair<float, float> minmax(const float* data, size_t n) {
+#ifdef IMETH_HAVE_AVX2_KERNELS
+    if (isa() != Isa::Generic) return minmax_avx2(data, n);
+#endif
+    return minmax_generic(data, n);
+}
+
+const char* instruction_set() {
+    switch (isa()) {
+    case Isa::Avx512: return "avx512";
+    case Isa::Avx2: return "avx2";
+    default: return "generic";
+    }
+}
+
+} // namespace imeth::detail::simd
@@ -0,0 +1,57 @@
+#pragma once
+#include <cstddef>
+#include <utility>
+
+// Vectorized reduction kernels shared by the statistics code.
+//
+// Sums accumulate in 16 double-precision lanes: element i goes to lane i % 16 and the lanes
+// are folded in a fixed pairwise tree. Every instruction set (scalar, AVX2, AVX-512) follows
+// this exact order, so a sum is bit-identical on every machine. AVX2 and AVX-512 versions are
+// picked at runtime on GCC/Clang x86 builds, and at compile time elsewhere.
+namespace imeth::detail::simd {
+
+constexpr size_t LANES = 16;
+
+double sum(const double* data, size_t n);
+double sum(const float* data, size_t n);  // accumulated in double
+
+// Recursive halving down to 256-element leaves, each summed by sum(); error grows with log n
+double sum_pairwise(const double* data, size_t n);
+double sum_pairwise(const float* data, size_t n);
+
+// Neumaier (Kahan-Babuska) summation in the same 16 lanes. The running sum and the accumulated
+// rounding error are returned separately so partial results can be combined without loss.
+struct CompensatedSum {
+    double sum;
+    double error;
+};
+CompensatedSum sum_compensated(const double* data, size_t n);
+CompensatedSum sum_compensated(const float* data, size_t n);
+
+// Shifted sums and cross products of paired columns, for co-moment (covariance) updates:
+// dx = x - shift_x, dy = y - shift_y. Accumulated in CO_LANES lanes folded pairwise, in the
+// same order on every instruction set.
+constexpr size_t CO_LANES = 8;
+struct CoMoments {
+    double dx;
+    double dy;
+    double dxx;
+    double dyy;
+    double dxy;
+};
+CoMoments co_moments(const double* x, const double* y, size_t n, double shift_x, double shift_y);
+
+// n must be > 0. NaN elements are skipped, except a NaN first element, which makes the
+// result NaN; every instruction set gives the same answer for any position of the NaN.
+double min(const double* data, size_t n);
+float min(const float* data, size_t n);
+double max(const double* data, size_t n);
+float max(const float* data, size_t n);
+// {min, max} in a single pass, equal to calling min and max
+std::pair<double, double> minmax(const double* data, size_t n);
+std::pair<float, float> minmax(const float* data, size_t n);
+
+// Name of the kernel set selected for this CPU ("avx512", "avx2" or "generic")
+const char* instruction_set();
+
+} // namespace imeth::detail::simd
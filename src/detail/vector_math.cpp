@@ -0,0 +1,294 @@
+#include "vector_math.hpp"
+#include "isa.hpp"
+#include <bit>
+#include <cmath>
+#include <cstdint>
+
+namespace imeth::detail::vmath {
+
+namespace {
+
+// fdlibm's cbrt seed: dividing the high word of the bits by 3 divides the exponent by 3, and
+// the bias constant re-centres it; relative error of the seed is below 1/15
+constexpr std::uint64_t CBRT_BIAS = 715094163;
+constexpr double TWO52 = 0x1p52;
+constexpr double TWO54 = 0x1p54;
+constexpr double TWO_MINUS54 = 0x1p-54;
+constexpr double TWO18 = 0x1p18;          // cbrt(2^54)
+constexpr double TWO_MINUS18 = 0x1p-18;  // cbrt(2^-54)
+constexpr double MIN_NORMAL = 0x1p-1022;
+constexpr double HUGE_INPUT = 0x1p1020;   // above this y^3 can overflow while iterating
+constexpr int HALLEY_STEPS = 2;
+
+// The seed division goes through doubles (exact for a 32-bit high word, rounded to nearest)
+// because AVX2 has no 64-bit integer division or conversion; the scalar code does the same.
+double cbrt_scalar(double x) {
+    const double ax = std::abs(x);
+    if (ax == 0.0 || !(ax <= 1.7976931348623157e308)) return x; // 0, inf, NaN
+    const bool tiny = ax < MIN_NORMAL;
+    const bool huge = ax > HUGE_INPUT;
+    const double scaled = tiny ? ax * TWO54 : huge ? ax * TWO_MINUS54 : ax;
+
+    const std::uint64_t hx = std::bit_cast<std::uint64_t>(scaled) >> 32;
+    const double third = (std::bit_cast<double>(hx | std::bit_cast<std::uint64_t>(TWO52)) - TWO52) * (1.0 / 3.0);
+    const std::uint64_t q = std::bit_cast<std::uint64_t>(third + TWO52) & 0xffffffffu;
+    double y = std::bit_cast<double>((q + CBRT_BIAS) << 32);
+
+    for (int step = 0; step < HALLEY_STEPS; ++step) {
+        const double r = y * y * y;
+        // Ratio first: y * (x - r) alone would overflow or underflow at the ends of the range
+        y = y + y * ((scaled - r) / (r + r + scaled));
+    }
+    // Final Newton step in the form y - (y - x / y^2) / 3: the difference is tiny and exact, so
+    // only the division and the last subtraction round
+    y = y - (y - scaled / (y * y)) * (1.0 / 3.0);
+    if (tiny) y *= TWO_MINUS18;
+    if (huge) y *= TWO18;
+    return x < 0 ? -y : y;
+}
+
+void cbrt_generic(const double* in, double* out, size_t n) {
+    for (size_t i = 0; i < n; ++i) out[i] = cbrt_scalar(in[i]);
+}
+
+bool sqrt_generic(const double* in, double* out, size_t n) {
+    bool negative = false;
+    for (size_t i = 0; i < n; ++i) {
+        negative |= in[i] < 0.0;
+        out[i] = std::sqrt(in[i]);
+    }
+    return negative;
+}
+
+// Magnitude as unsigned so INT_MIN is fine
+unsigned magnitude(int exponent) {
+    return exponent < 0 ? 0u - static_cast<unsigned>(exponent) : static_cast<unsigned>(exponent);
+}
+
+double powi_scalar(double x, unsigned e, bool reciprocal) {
+    double result = 1.0;
+    while (e != 0) {
+        if (e & 1u) result *= x;
+        e >>= 1;
+        if (e != 0) x *= x;
+    }
+    return reciprocal ? 1.0 / result : result;
+}
+
+void powi_generic(const double* in, unsigned e, bool reciprocal, double* out, size_t n) {
+    for (size_t i = 0; i < n; ++i) out[i] = powi_scalar(in[i], e, reciprocal);
+}
+
+#ifdef IMETH_HAVE_AVX2_KERNELS
+
+IMETH_TARGET("avx2") bool sqrt_avx2(const double* in, double* out, size_t n) {
+    const __m256d zero = _mm256_setzero_pd();
+    __m256d negative = zero;
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        const __m256d x = _mm256_loadu_pd(in + i);
+        negative = _mm256_or_pd(negative, _mm256_cmp_pd(x, zero, _CMP_LT_OQ));
+        _mm256_storeu_pd(out + i, _mm256_sqrt_pd(x));
+    }
+    return (_mm256_movemask_pd(negative) != 0) | sqrt_generic(in + i, out + i, n - i);
+}
+
+IMETH_TARGET("avx2") __m256d cbrt_avx2_lanes(__m256d x) {
+    const __m256d sign_mask = _mm256_set1_pd(-0.0);
+    const __m256d ax = _mm256_andnot_pd(sign_mask, x);
+    const __m256d special = _mm256_or_pd(_mm256_cmp_pd(ax, _mm256_setzero_pd(), _CMP_EQ_OQ),
+                                         _mm256_cmp_pd(ax, _mm256_set1_pd(1.7976931348623157e308), _CMP_NLE_UQ));
+    const __m256d tiny = _mm256_cmp_pd(ax, _mm256_set1_pd(MIN_NORMAL), _CMP_LT_OQ);
+    const __m256d huge = _mm256_cmp_pd(ax, _mm256_set1_pd(HUGE_INPUT), _CMP_GT_OQ);
+    __m256d scaled = _mm256_blendv_pd(ax, _mm256_mul_pd(ax, _mm256_set1_pd(TWO54)), tiny);
+    scaled = _mm256_blendv_pd(scaled, _mm256_mul_pd(ax, _mm256_set1_pd(TWO_MINUS54)), huge);
+
+    const __m256d two52 = _mm256_set1_pd(TWO52);
+    const __m256i hx = _mm256_srli_epi64(_mm256_castpd_si256(scaled), 32);
+    const __m256d hx_d = _mm256_sub_pd(_mm256_castsi256_pd(_mm256_or_si256(hx, _mm256_castpd_si256(two52))), two52);
+    const __m256d third = _mm256_mul_pd(hx_d, _mm256_set1_pd(1.0 / 3.0));
+    const __m256i q = _mm256_and_si256(_mm256_castpd_si256(_mm256_add_pd(third, two52)),
+                                       _mm256_set1_epi64x(0xffffffff));
+    __m256d y = _mm256_castsi256_pd(_mm256_slli_epi64(_mm256_add_epi64(q, _mm256_set1_epi64x(CBRT_BIAS)), 32));
+
+    for (int step = 0; step < HALLEY_STEPS; ++step) {
+        const __m256d r = _mm256_mul_pd(_mm256_mul_pd(y, y), y);
+        const __m256d den = _mm256_add_pd(_mm256_add_pd(r, r), scaled);
+        y = _mm256_add_pd(y, _mm256_mul_pd(y, _mm256_div_pd(_mm256_sub_pd(scaled, r), den)));
+    }
+    const __m256d quotient = _mm256_div_pd(scaled, _mm256_mul_pd(y, y));
+    y = _mm256_sub_pd(y, _mm256_mul_pd(_mm256_sub_pd(y, quotient), _mm256_set1_pd(1.0 / 3.0)));
+    y = _mm256_blendv_pd(y, _mm256_mul_pd(y, _mm256_set1_pd(TWO_MINUS18)), tiny);
+    y = _mm256_blendv_pd(y, _mm256_mul_pd(y, _mm256_set1_pd(TWO18)), huge);
+    y = _mm256_or_pd(y, _mm256_and_pd(x, sign_mask));
+    return _mm256_blendv_pd(y, x, special);
+}
+
+IMETH_TARGET("avx2") void cbrt_avx2(const double* in, double* out, size_t n) {
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        const __m256d a = cbrt_avx2_lanes(_mm256_loadu_pd(in + i));
+        const __m256d b = cbrt_avx2_lanes(_mm256_loadu_pd(in + i + 4));
+        _mm256_storeu_pd(out + i, a);
+        _mm256_storeu_pd(out + i + 4, b);
+    }
+    cbrt_generic(in + i, out + i, n - i);
+}
+
+IMETH_TARGET("avx2") void powi_avx2(const double* in, unsigned e, bool reciprocal, double* out, size_t n) {
+    const __m256d one = _mm256_set1_pd(1.0);
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        __m256d x0 = _mm256_loadu_pd(in + i), x1 = _mm256_loadu_pd(in + i + 4);
+        __m256d r0 = one, r1 = one;
+        for (unsigned k = e; k != 0;) {
+            if (k & 1u) {
+                r0 = _mm256_mul_pd(r0, x0);
+                r1 = _mm256_mul_pd(r1, x1);
+            }
+            k >>= 1;
+            if (k != 0) {
+                x0 = _mm256_mul_pd(x0, x0);
+                x1 = _mm256_mul_pd(x1, x1);
+            }
+        }
+        if (reciprocal) {
+            r0 = _mm256_div_pd(one, r0);
+            r1 = _mm256_div_pd(one, r1);
+        }
+        _mm256_storeu_pd(out + i, r0);
+        _mm256_storeu_pd(out + i + 4, r1);
+    }
+    powi_generic(in + i, e, reciprocal, out + i, n - i);
+}
+
+#endif
+
+#ifdef IMETH_HAVE_AVX512_KERNELS
+
+IMETH_TARGET("avx512f") bool sqrt_avx512(const double* in, double* out, size_t n) {
+    const __m512d zero = _mm512_setzero_pd();
+    __mmask8 negative = 0;
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        const __m512d x = _mm512_loadu_pd(in + i);
+        negative |= _mm512_cmp_pd_mask(x, zero, _CMP_LT_OQ);
+        _mm512_storeu_pd(out + i, _mm512_sqrt_pd(x));
+    }
+    return (negative != 0) | sqrt_generic(in + i, out + i, n - i);
+}
+
+IMETH_TARGET("avx512f") __m512d cbrt_avx512_lanes(__m512d x) {
+    const __m512d ax = _mm512_abs_pd(x);
+    const __mmask8 special = _mm512_cmp_pd_mask(ax, _mm512_setzero_pd(), _CMP_EQ_OQ) |
+                             _mm512_cmp_pd_mask(ax, _mm512_set1_pd(1.7976931348623157e308), _CMP_NLE_UQ);
+    const __mmask8 tiny = _mm512_cmp_pd_mask(ax, _mm512_set1_pd(MIN_NORMAL), _CMP_LT_OQ);
+    const __mmask8 huge = _mm512_cmp_pd_mask(ax, _mm512_set1_pd(HUGE_INPUT), _CMP_GT_OQ);
+    __m512d scaled = _mm512_mask_mul_pd(ax, tiny, ax, _mm512_set1_pd(TWO54));
+    scaled = _mm512_mask_mul_pd(scaled, huge, ax, _mm512_set1_pd(TWO_MINUS54));
+
+    const __m512d two52 = _mm512_set1_pd(TWO52);
+    const __m512i hx = _mm512_srli_epi64(_mm512_castpd_si512(scaled), 32);
+    const __m512d hx_d = _mm512_sub_pd(_mm512_castsi512_pd(_mm512_or_si512(hx, _mm512_castpd_si512(two52))), two52);
+    const __m512d third = _mm512_mul_pd(hx_d, _mm512_set1_pd(1.0 / 3.0));
+    const __m512i q = _mm512_and_si512(_mm512_castpd_si512(_mm512_add_pd(third, two52)),
+                                       _mm512_set1_epi64(0xffffffff));
+    __m512d y = _mm512_castsi512_pd(_mm512_slli_epi64(_mm512_add_epi64(q, _mm512_set1_epi64(CBRT_BIAS)), 32));
+
+    for (int step = 0; step < HALLEY_STEPS; ++step) {
+        const __m512d r = _mm512_mul_pd(_mm512_mul_pd(y, y), y);
+        const __m512d den = _mm512_add_pd(_mm512_add_pd(r, r), scaled);
+        y = _mm512_add_pd(y, _mm512_mul_pd(y, _mm512_div_pd(_mm512_sub_pd(scaled, r), den)));
+    }
+    const __m512d quotient = _mm512_div_pd(scaled, _mm512_mul_pd(y, y));
+    y = _mm512_sub_pd(y, _mm512_mul_pd(_mm512_sub_pd(y, quotient), _mm512_set1_pd(1.0 / 3.0)));
+    y = _mm512_mask_mul_pd(y, tiny, y, _mm512_set1_pd(TWO_MINUS18));
+    y = _mm512_mask_mul_pd(y, huge, y, _mm512_set1_pd(TWO18));
+    const __m512i sign = _mm512_and_si512(_mm512_castpd_si512(x), _mm512_set1_epi64(static_cast<long long>(0x8000000000000000ull)));
+    y = _mm512_castsi512_pd(_mm512_or_si512(_mm512_castpd_si512(y), sign));
+    return _mm512_mask_blend_pd(special, y, x);
+}
+
+IMETH_TARGET("avx512f") void cbrt_avx512(const double* in, double* out, size_t n) {
+    size_t i = 0;
+    for (; i + 16 <= n; i += 16) {
+        const __m512d a = cbrt_avx512_lanes(_mm512_loadu_pd(in + i));
+        const __m512d b = cbrt_avx512_lanes(_mm512_loadu_pd(in + i + 8));
+        _mm512_storeu_pd(out + i, a);
+        _mm512_storeu_pd(out + i + 8, b);
+    }
+    cbrt_generic(in + i, out + i, n - i);
+}
+
+IMETH_TARGET("avx512f") void powi_avx512(const double* in, unsigned e, bool reciprocal, double* out, size_t n) {
+    const __m512d one = _mm512_set1_pd(1.0);
+    size_t i = 0;
+    for (; i + 16 <= n; i += 16) {
+        __m512d x0 = _mm512_loadu_pd(in + i), x1 = _mm512_loadu_pd(in + i + 8);
+        __m512d r0 = one, r1 = one;
+        for (unsigned k = e; k != 0;) {
+            if (k & 1u) {
+                r0 = _mm512_mul_pd(r0, x0);
+                r1 = _mm512_mul_pd(r1, x1);
+            }
+            k >>= 1;
+            if (k != 0) {
+                x0 = _mm512_mul_pd(x0, x0);
+                x1 = _mm512_mul_pd(x1, x1);
+            }
+        }
+        if (reciprocal) {
+            r0 = _mm512_div_pd(one, r0);
+            r1 = _mm512_div_pd(one, r1);
+        }
+        _mm512_storeu_pd(out + i, r0);
+        _mm512_storeu_pd(out + i + 8, r1);
+    }
+    powi_generic(in + i, e, reciprocal, out + i, n - i);
+}
+
+#endif
+
+} // namespace
+
+bool sqrt(const double* in, double* out, size_t n) {
+#ifdef IMETH_HAVE_AVX512_KERNELS
+    if (isa() == Isa::Avx512) return sqrt_avx512(in, out, n);
+#endif
+#ifdef IMETH_HAVE_AVX2_KERNELS
+    if (isa() != Isa::Generic) return sqrt_avx2(in, out, n);
+#endif
+    return sqrt_generic(in, out, n);
+}
+
+void cbrt(const double* in, double* out, size_t n) {
+#ifdef IMETH_HAVE_AVX512_KERNELS
+    if (isa() == Isa::Avx512) return cbrt_avx512(in, out, n);
+#endif
+#ifdef IMETH_HAVE_AVX2_KERNELS
+    if (isa() != Isa::Generic) return cbrt_avx2(in, out, n);
+#endif
+    cbrt_generic(in, out, n);
+}
+
+double cbrt(double x) {
+    return cbrt_scalar(x);
+}
+
+double powi(double x, int exponent) {
+    return powi_scalar(x, magnitude(exponent), exponent < 0);
+}
+
+void powi(const double* in, int exponent, double* out, size_t n) {
+    const unsigned e = magnitude(exponent);
+    const bool reciprocal = exponent < 0;
+#ifdef IMETH_HAVE_AVX512_KERNELS
+    if (isa() == Isa::Avx512) return powi_avx512(in, e, reciprocal, out, n);
+#endif
+#ifdef IMETH_HAVE_AVX2_KERNELS
+    if (isa() != Isa::Generic) return powi_avx2(in, e, reciprocal, out, n);
+#endif
+    powi_generic(in, e, reciprocal, out, n);
+}
+
+} // namespace imeth::detail::vmath
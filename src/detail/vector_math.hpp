@@ -0,0 +1,24 @@
+#pragma once
+#include <cstddef>
+
+// Element-wise math kernels, out[i] = f(in[i]). in and out may be the same buffer. The scalar
+// overloads run the exact same operations as one lane, so they return the same bits.
+// AVX2 and AVX-512 versions are picked at runtime like the reduction kernels in simd.hpp.
+namespace imeth::detail::vmath {
+
+// Hardware square root, correctly rounded. Returns true if any input was negative (those
+// outputs are NaN).
+bool sqrt(const double* in, double* out, size_t n);
+
+// Cube root: exponent-division bit seed, two Halley steps and a final Newton step; below 0.75 ulp
+// of the exact result over the whole double range, the same bits on every instruction set.
+// 0, inf and NaN are returned unchanged.
+void cbrt(const double* in, double* out, size_t n);
+double cbrt(double x);
+
+// in[i]^exponent by binary exponentiation; every lane follows the same squaring ladder.
+// Negative exponents take the reciprocal at the end. exponent 0 gives 1.
+void powi(const double* in, int exponent, double* out, size_t n);
+double powi(double x, int exponent);
+
+} // namespace imeth::detail::vmath
@@ -0,0 +1,140 @@
+#pragma once
+#include <cstdint>
+
+#if defined(_MSC_VER) && !defined(__clang__) && defined(_M_X64)
+#include <intrin.h>
+#define IMETH_MSVC_X64 1
+#endif
+
+// Full 64 x 64 -> 128-bit products. GCC and Clang use unsigned __int128; MSVC on x64 has
+// _umul128; anything else falls back to four 32-bit partial products. The same split holds for
+// overflow-checked arithmetic and 128-bit remainders below.
+namespace imeth::detail::wide {
+
+struct U128 {
+    std::uint64_t hi;
+    std::uint64_t lo;
+};
+
+inline U128 mul(std::uint64_t a, std::uint64_t b) {
+#if defined(__SIZEOF_INT128__)
+    const unsigned __int128 p = static_cast<unsigned __int128>(a) * b;
+    return {static_cast<std::uint64_t>(p >> 64), static_cast<std::uint64_t>(p)};
+#elif defined(IMETH_MSVC_X64)
+    std::uint64_t hi;
+    const std::uint64_t lo = _umul128(a, b, &hi);
+    return {hi, lo};
+#else
+    const std::uint64_t a_lo = a & 0xffffffffu, a_hi = a >> 32;
+    const std::uint64_t b_lo = b & 0xffffffffu, b_hi = b >> 32;
+    const std::uint64_t ll = a_lo * b_lo, lh = a_lo * b_hi, hl = a_hi * b_lo, hh = a_hi * b_hi;
+    const std::uint64_t middle = (ll >> 32) + (lh & 0xffffffffu) + (hl & 0xffffffffu);
+    return {hh + (lh >> 32) + (hl >> 32) + (middle >> 32), (middle << 32) | (ll & 0xffffffffu)};
+#endif
+}
+
+inline std::uint64_t mul_high(std::uint64_t a, std::uint64_t b) {
+    return mul(a, b).hi;
+}
+
+// a + b and a * b into out, modulo 2^64; true when the exact result does not fit. GCC and
+// Clang builtins compile to the plain instruction and a test of the carry/overflow flag.
+inline bool add_overflow(std::uint64_t a, std::uint64_t b, std::uint64_t& out) {
+#if defined(__GNUC__) || defined(__clang__)
+    return __builtin_add_overflow(a, b, &out);
+#else
+    out = a + b;
+    return out < a;
+#endif
+}
+
+inline bool mul_overflow(std::uint64_t a, std::uint64_t b, std::uint64_t& out) {
+#if defined(__GNUC__) || defined(__clang__)
+    return __builtin_mul_overflow(a, b, &out);
+#else
+    const U128 p = mul(a, b);
+    out = p.lo;
+    return p.hi != 0;
+#endif
+}
+
+// x mod m for a full 128-bit x, m > 0
+inline std::uint64_t mod(U128 x, std::uint64_t m) {
+#if defined(__SIZEOF_INT128__)
+    return static_cast<std::uint64_t>(((static_cast<unsigned __int128>(x.hi) << 64) | x.lo) % m);
+#elif defined(IMETH_MSVC_X64) && _MSC_VER >= 1920
+    std::uint64_t remainder;
+    _udiv128(x.hi % m, x.lo, m, &remainder);  // the high word must be below m
+    return remainder;
+#else
+    // Long division one bit at a time; r stays below m, and a bit shifted out of r means the
+    // true value is at least 2^64 > m
+    std::uint64_t r = x.hi % m;
+    for (int i = 63; i >= 0; --i) {
+        const bool carry = (r >> 63) != 0;
+        r = (r << 1) | ((x.lo >> i) & 1);
+        if (carry || r >= m) r -= m;
+    }
+    return r;
+#endif
+}
+
+// Arithmetic modulo an odd n in Montgomery form (R = 2^64): values are stored as x * R mod n,
+// so a modular product costs three multiplications and no division.
+class Montgomery {
+public:
+    explicit Montgomery(std::uint64_t n) : m_n(n) {
+        // Newton iteration for n^-1 mod 2^64; each step doubles the number of correct bits
+        std::uint64_t inverse = n;
+        for (int i = 0; i < 5; ++i) inverse *= 2 - n * inverse;
+        m_inverse = inverse;
+        // R mod n, then R^2 mod n by doubling 64 times
+        m_one = (0 - n) % n;
+        std::uint64_t r2 = m_one;
+        for (int i = 0; i < 64; ++i) r2 = add(r2, r2);
+        m_r2 = r2;
+    }
+
+    std::uint64_t modulus() const { return m_n; }
+    std::uint64_t one() const { return m_one; }
+
+    std::uint64_t to(std::uint64_t x) const { return multiply(x % m_n, m_r2); }
+    std::uint64_t from(std::uint64_t x) const { return reduce({0, x}); }
+
+    std::uint64_t add(std::uint64_t a, std::uint64_t b) const {
+        const std::uint64_t s = a + b;
+        return (s < a || s >= m_n) ? s - m_n : s;
+    }
+
+    std::uint64_t subtract(std::uint64_t a, std::uint64_t b) const {
+        return a >= b ? a - b : a - b + m_n;
+    }
+
+    std::uint64_t multiply(std::uint64_t a, std::uint64_t b) const { return reduce(mul(a, b)); }
+
+    std::uint64_t power(std::uint64_t base, std::uint64_t exponent) const {
+        std::uint64_t result = m_one;
+        while (exponent != 0) {
+            if (exponent & 1) result = multiply(result, base);
+            base = multiply(base, base);
+            exponent >>= 1;
+        }
+        return result;
+    }
+
+private:
+    // t * R^-1 mod n for t < n * 2^64
+    std::uint64_t reduce(U128 t) const {
+        const std::uint64_t m = t.lo * m_inverse;
+        const std::uint64_t mn_hi = mul_high(m, m_n);
+        // t - m * n is divisible by 2^64, and its low words cancel exactly
+        return t.hi >= mn_hi ? t.hi - mn_hi : t.hi - mn_hi + m_n;
+    }
+
+    std::uint64_t m_n;
+    std::uint64_t m_inverse{};
+    std::uint64_t m_one{};
+    std::uint64_t m_r2{};
+};
+
+} // namespace imeth::detail::wide
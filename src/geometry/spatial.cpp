@@ -0,0 +1,315 @@
+#include "../include/imeth/geometry/spatial.hpp"
+#include "../detail/parallel.hpp"
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+#include <stdexcept>
+
+namespace imeth::Spatial {
+
+namespace {
+
+// Points of b handled per tile of the direct kernel; their coordinates are transposed so the
+// inner loop runs across points and vectorizes
+constexpr size_t TILE = 256;
+// Points of b per register block of the direct kernel; divides TILE
+constexpr size_t BLOCK = 8;
+// Below this many coordinate operations threads cost more than they save
+constexpr size_t PARALLEL_WORK = size_t{1} << 18;
+// Queries per parallel chunk
+constexpr size_t QUERY_GRAIN = 64;
+
+size_t grain_for(size_t work_per_item) {
+    return std::max<size_t>(1, PARALLEL_WORK / std::max<size_t>(work_per_item, 1));
+}
+
+void check_dimensions(const Matrix& a, const Matrix& b) {
+    if (a.cols() != b.cols()) {
+        throw std::invalid_argument("Point sets must have the same dimension");
+    }
+}
+
+// Squared distances, every row of a against every row of b, straight from the coordinates
+void direct_distances(const Matrix& a, const Matrix& b, Matrix& result) {
+    const size_t m = a.rows(), p = b.rows(), d = a.cols();
+    const double* A = a.data();
+    const double* B = b.data();
+    double* out = result.data();
+    detail::parallel_for(0, m, grain_for(p * d), [=](size_t r0, size_t r1) {
+        std::vector<double> tile(d * TILE, 0.0);
+        for (size_t jj = 0; jj < p; jj += TILE) {
+            const size_t jn = std::min(TILE, p - jj);
+            for (size_t j = 0; j < jn; ++j)
+                for (size_t k = 0; k < d; ++k) tile[k * TILE + j] = B[(jj + j) * d + k];
+            for (size_t i = r0; i < r1; ++i) {
+                const double* ai = A + i * d;
+                double* row = out + i * p + jj;
+                // BLOCK sums stay in registers across all coordinates. TILE is a multiple of
+                // BLOCK, so a short last block just reads (and drops) leftover tile columns.
+                for (size_t j0 = 0; j0 < jn; j0 += BLOCK) {
+                    double sum[BLOCK] = {};
+                    for (size_t k = 0; k < d; ++k) {
+                        const double* column = tile.data() + k * TILE + j0;
+                        for (size_t l = 0; l < BLOCK; ++l) {
+                            const double t = ai[k] - column[l];
+                            sum[l] += t * t;
+                        }
+                    }
+                    std::copy(sum, sum + std::min(BLOCK, jn - j0), row + j0);
+                }
+            }
+        }
+    });
+}
+
+// Squared distances as |a|^2 + |b|^2 - 2 a.b, with the products from the matrix multiply
+void gemm_distances(const Matrix& a, const Matrix& b, Matrix& result) {
+    const size_t m = a.rows(), p = b.rows(), d = a.cols();
+    result = a.multiply_transpose(b);
+    std::vector<double> norm_a(m), norm_b(p);
+    for (size_t i = 0; i < m; ++i)
+        norm_a[i] = std::inner_product(a.data() + i * d, a.data() + (i + 1) * d, a.data() + i * d, 0.0);
+    for (size_t j = 0; j < p; ++j)
+        norm_b[j] = std::inner_product(b.data() + j * d, b.data() + (j + 1) * d, b.data() + j * d, 0.0);
+    double* out = result.data();
+    detail::parallel_for(0, m, grain_for(p), [&](size_t r0, size_t r1) {
+        for (size_t i = r0; i < r1; ++i)
+            for (size_t j = 0; j < p; ++j)  // cancellation can leave tiny negatives
+                out[i * p + j] = std::max(0.0, norm_a[i] + norm_b[j] - 2.0 * out[i * p + j]);
+    });
+}
+
+void take_roots(Matrix& result) {
+    double* out = result.data();
+    const size_t total = result.rows() * result.cols();
+    detail::parallel_for(0, total, PARALLEL_WORK, [=](size_t lo, size_t hi) {
+        for (size_t i = lo; i < hi; ++i) out[i] = std::sqrt(out[i]);
+    });
+}
+
+// Max-heap order on (distance, index): the front of the heap is the worst neighbour kept
+bool closer(const Neighbor& a, const Neighbor& b) {
+    return a.distance < b.distance || (a.distance == b.distance && a.index < b.index);
+}
+
+// Range of the heap-order node at `level` with position `position` in that level; every node
+// splits its range at the midpoint, so ranges follow from n alone
+std::pair<size_t, size_t> node_range(size_t n, size_t level, size_t position) {
+    size_t lo = 0, hi = n;
+    for (size_t l = level; l-- > 0;) {
+        const size_t mid = lo + (hi - lo) / 2;
+        if ((position >> l) & 1) lo = mid; else hi = mid;
+    }
+    return {lo, hi};
+}
+
+} // namespace
+
+Matrix pairwise_distances(const Matrix& a, const Matrix& b, const bool squared) {
+    check_dimensions(a, b);
+    Matrix result(a.rows(), b.rows());
+    if (a.rows() == 0 || b.rows() == 0) return result;
+    if (a.cols() >= GEMM_DIMENSION)
+        gemm_distances(a, b, result);
+    else
+        direct_distances(a, b, result);
+    if (!squared) take_roots(result);
+    return result;
+}
+
+Matrix pairwise_distances(const Matrix& points, const bool squared) {
+    Matrix result = pairwise_distances(points, points, squared);
+    // Both kernels are symmetric already; the GEMM one needs its diagonal cleaned up
+    for (size_t i = 0; i < points.rows(); ++i) result.data()[i * points.rows() + i] = 0.0;
+    return result;
+}
+
+KDTree::KDTree(const Matrix& points, const size_t leaf_size)
+    : m_size(points.rows()), m_dimension(points.cols()), m_depth(0) {
+    if (m_size == 0 || m_dimension == 0) {
+        throw std::invalid_argument("Cannot build a k-d tree over an empty point set");
+    }
+    if (leaf_size == 0) {
+        throw std::invalid_argument("Leaf size must be positive");
+    }
+    const size_t d = m_dimension;
+    const double* P = points.data();
+    for (size_t i = 0; i < m_size * d; ++i) {
+        if (!std::isfinite(P[i])) {
+            throw std::invalid_argument("Point coordinates must be finite");
+        }
+    }
+
+    // Deep enough that the largest leaf holds at most leaf_size points
+    while (((m_size - 1) >> m_depth) + 1 > leaf_size) ++m_depth;
+    m_nodes.resize((size_t{1} << m_depth) - 1);
+    m_index.resize(m_size);
+    std::iota(m_index.begin(), m_index.end(), size_t{0});
+
+    // One level at a time: the nodes of a level own disjoint ranges, so they sort in parallel
+    for (size_t level = 0; level < m_depth; ++level) {
+        const size_t count = size_t{1} << level;
+        const size_t first = count - 1;
+        detail::parallel_for(0, count, grain_for((m_size >> level) * d), [&](size_t n0, size_t n1) {
+            std::vector<double> low(d), high(d);
+            for (size_t position = n0; position < n1; ++position) {
+                const auto [lo, hi] = node_range(m_size, level, position);
+                // Split the widest coordinate
+                for (size_t k = 0; k < d; ++k) low[k] = high[k] = P[m_index[lo] * d + k];
+                for (size_t i = lo + 1; i < hi; ++i)
+                    for (size_t k = 0; k < d; ++k) {
+                        const double v = P[m_index[i] * d + k];
+                        low[k] = std::min(low[k], v);
+                        high[k] = std::max(high[k], v);
+                    }
+                size_t widest = 0;
+                for (size_t k = 1; k < d; ++k)
+                    if (high[k] - low[k] > high[widest] - low[widest]) widest = k;
+
+                const size_t mid = lo + (hi - lo) / 2;
+                std::nth_element(m_index.begin() + lo, m_index.begin() + mid, m_index.begin() + hi,
+                                 [&](size_t x, size_t y) { return P[x * d + widest] < P[y * d + widest]; });
+                m_nodes[first + position] = {static_cast<std::uint32_t>(widest), P[m_index[mid] * d + widest]};
+            }
+        });
+    }
+
+    // Leaves become contiguous runs of coordinates
+    m_points.resize(m_size * d);
+    detail::parallel_for(0, m_size, grain_for(d), [&](size_t lo, size_t hi) {
+        for (size_t i = lo; i < hi; ++i)
+            std::copy(P + m_index[i] * d, P + (m_index[i] + 1) * d, m_points.begin() + i * d);
+    });
+}
+
+size_t KDTree::size() const { return m_size; }
+size_t KDTree::dimension() const { return m_dimension; }
+
+void KDTree::check_query(const size_t coordinates) const {
+    if (coordinates != m_dimension) {
+        throw std::invalid_argument("Query dimension does not match the indexed points");
+    }
+}
+
+// Depth-first, nearer child first; the farther child is skipped once the splitting plane is
+// farther away than the current k-th neighbour. heap holds squared distances.
+void KDTree::search_nearest(const double* query, const size_t k, std::vector<Neighbor>& heap) const {
+    const size_t d = m_dimension;
+    auto visit = [&](auto&& self, size_t node, size_t level, size_t lo, size_t hi) -> void {
+        if (level == m_depth) {
+            for (size_t i = lo; i < hi; ++i) {
+                const double* point = m_points.data() + i * d;
+                double distance = 0.0;
+                for (size_t c = 0; c < d; ++c) distance += (query[c] - point[c]) * (query[c] - point[c]);
+                const Neighbor candidate{m_index[i], distance};
+                if (heap.size() < k) {
+                    heap.push_back(candidate);
+                    std::push_heap(heap.begin(), heap.end(), closer);
+                } else if (closer(candidate, heap.front())) {
+                    std::pop_heap(heap.begin(), heap.end(), closer);
+                    heap.back() = candidate;
+                    std::push_heap(heap.begin(), heap.end(), closer);
+                }
+            }
+            return;
+        }
+        const Node& n = m_nodes[node];
+        const double offset = query[n.dimension] - n.split;
+        const size_t mid = lo + (hi - lo) / 2;
+        if (offset < 0.0) {
+            self(self, 2 * node + 1, level + 1, lo, mid);
+            if (heap.size() < k || offset * offset <= heap.front().distance)
+                self(self, 2 * node + 2, level + 1, mid, hi);
+        } else {
+            self(self, 2 * node + 2, level + 1, mid, hi);
+            if (heap.size() < k || offset * offset <= heap.front().distance)
+                self(self, 2 * node + 1, level + 1, lo, mid);
+        }
+    };
+    heap.clear();
+    visit(visit, 0, 0, 0, m_size);
+    std::sort_heap(heap.begin(), heap.end(), closer);
+}
+
+void KDTree::search_within(const double* query, const double radius_squared, std::vector<Neighbor>& out) const {
+    const size_t d = m_dimension;
+    auto visit = [&](auto&& self, size_t node, size_t level, size_t lo, size_t hi) -> void {
+        if (level == m_depth) {
+            for (size_t i = lo; i < hi; ++i) {
+                const double* point = m_points.data() + i * d;
+                double distance = 0.0;
+                for (size_t c = 0; c < d; ++c) distance += (query[c] - point[c]) * (query[c] - point[c]);
+                if (distance <= radius_squared) out.push_back({m_index[i], distance});
+            }
+            return;
+        }
+        const Node& n = m_nodes[node];
+        const double offset = query[n.dimension] - n.split;
+        const size_t mid = lo + (hi - lo) / 2;
+        if (offset <= 0.0 || offset * offset <= radius_squared) self(self, 2 * node + 1, level + 1, lo, mid);
+        if (offset >= 0.0 || offset * offset <= radius_squared) self(self, 2 * node + 2, level + 1, mid, hi);
+    };
+    out.clear();
+    visit(visit, 0, 0, 0, m_size);
+    std::sort(out.begin(), out.end(), closer);
+}
+
+std::vector<Neighbor> KDTree::nearest(std::span<const double> query, const size_t k) const {
+    check_query(query.size());
+    if (k == 0 || k > m_size) {
+        throw std::invalid_argument("k must be between 1 and the number of points");
+    }
+    std::vector<Neighbor> result;
+    result.reserve(k);
+    search_nearest(query.data(), k, result);
+    for (Neighbor& n : result) n.distance = std::sqrt(n.distance);
+    return result;
+}
+
+Neighbors KDTree::nearest(const Matrix& queries, const size_t k) const {
+    check_query(queries.cols());
+    if (k == 0 || k > m_size) {
+        throw std::invalid_argument("k must be between 1 and the number of points");
+    }
+    Neighbors result{k, std::vector<size_t>(queries.rows() * k), std::vector<double>(queries.rows() * k)};
+    detail::parallel_for(0, queries.rows(), QUERY_GRAIN, [&](size_t q0, size_t q1) {
+        std::vector<Neighbor> heap;
+        heap.reserve(k);
+        for (size_t q = q0; q < q1; ++q) {
+            search_nearest(queries.data() + q * m_dimension, k, heap);
+            for (size_t j = 0; j < k; ++j) {
+                result.indices[q * k + j] = heap[j].index;
+                result.distances[q * k + j] = std::sqrt(heap[j].distance);
+            }
+        }
+    });
+    return result;
+}
+
+std::vector<Neighbor> KDTree::within(std::span<const double> query, const double radius) const {
+    check_query(query.size());
+    if (!(radius >= 0.0)) {
+        throw std::invalid_argument("Radius must be non-negative");
+    }
+    std::vector<Neighbor> result;
+    search_within(query.data(), radius * radius, result);
+    for (Neighbor& n : result) n.distance = std::sqrt(n.distance);
+    return result;
+}
+
+std::vector<std::vector<Neighbor>> KDTree::within(const Matrix& queries, const double radius) const {
+    check_query(queries.cols());
+    if (!(radius >= 0.0)) {
+        throw std::invalid_argument("Radius must be non-negative");
+    }
+    std::vector<std::vector<Neighbor>> result(queries.rows());
+    detail::parallel_for(0, queries.rows(), QUERY_GRAIN, [&](size_t q0, size_t q1) {
+        for (size_t q = q0; q < q1; ++q) {
+            search_within(queries.data() + q * m_dimension, radius * radius, result[q]);
+            for (Neighbor& n : result[q]) n.distance = std::sqrt(n.distance);
+        }
+    });
+    return result;
+}
+
+} // namespace imeth::Spatial
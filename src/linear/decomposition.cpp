@@ -0,0 +1,177 @@
+#include "../include/imeth/linear/decomposition.hpp"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <numeric>
+#include <random>
+#include <stdexcept>
+
+namespace imeth {
+
+namespace {
+
+// One-sided Jacobi (Hestenes) on the rows of M (l x n): rotates row pairs until they are
+// mutually orthogonal. Afterwards row i = sigma_i * v_i^T, and V (l x l) holds the rotations.
+void one_sided_jacobi(Matrix& M, Matrix& V) {
+    const size_t l = M.rows(), n = M.cols();
+    double* m = M.data();
+    double* v = V.data();
+    constexpr double eps = std::numeric_limits<double>::epsilon();
+
+    for (int sweep = 0; sweep < 60; ++sweep) {
+        bool rotated = false;
+        for (size_t i = 0; i + 1 < l; ++i) {
+            for (size_t j = i + 1; j < l; ++j) {
+                double* mi = m + i * n;
+                double* mj = m + j * n;
+                double alpha = 0.0, beta = 0.0, gamma = 0.0;
+                for (size_t c = 0; c < n; ++c) {
+                    alpha += mi[c] * mi[c];
+                    beta += mj[c] * mj[c];
+                    gamma += mi[c] * mj[c];
+                }
+                if (std::abs(gamma) <= eps * std::sqrt(alpha * beta)) continue;
+
+                rotated = true;
+                const double zeta = (beta - alpha) / (2.0 * gamma);
+                const double t = std::copysign(1.0, zeta) / (std::abs(zeta) + std::sqrt(1.0 + zeta * zeta));
+                const double cs = 1.0 / std::sqrt(1.0 + t * t);
+                const double sn = cs * t;
+                for (size_t c = 0; c < n; ++c) {
+                    const double a = mi[c], b = mj[c];
+                    mi[c] = cs * a - sn * b;
+                    mj[c] = sn * a + cs * b;
+                }
+                for (size_t r = 0; r < l; ++r) {
+                    const double a = v[r * l + i], b = v[r * l + j];
+                    v[r * l + i] = cs * a - sn * b;
+                    v[r * l + j] = sn * a + cs * b;
+                }
+            }
+        }
+        if (!rotated) return;
+    }
+}
+
+Matrix gaussian_matrix(size_t rows, size_t cols, std::mt19937_64& rng) {
+    std::normal_distribution<double> dist;
+    Matrix G(rows, cols);
+    double* g = G.data();
+    for (size_t i = 0; i < rows * cols; ++i) g[i] = dist(rng);
+    return G;
+}
+
+} // namespace
+
+Decomposition::QR Decomposition::qr(const Matrix& A) {
+    const size_t m = A.rows(), n = A.cols();
+    if (m < n)
+        throw std::invalid_argument("QR decomposition requires rows >= cols");
+
+    // Householder reflections, applied row by row so the row-major storage is streamed
+    Matrix H = A;
+    double* h = H.data();
+    std::vector<double> tau(n), w(n);
+
+    for (size_t k = 0; k < n; ++k) {
+        double norm2 = 0.0;
+        for (size_t r = k; r < m; ++r) norm2 += h[r * n + k] * h[r * n + k];
+        const double norm = std::sqrt(norm2);
+        if (norm == 0.0) {
+            tau[k] = 0.0;
+            continue;
+        }
+
+        // v = x + sign(x0) ||x|| e0, scaled so v0 = 1; stored below the diagonal
+        const double x0 = h[k * n + k];
+        const double alpha = -std::copysign(norm, x0);
+        const double v0 = x0 - alpha;
+        for (size_t r = k + 1; r < m; ++r) h[r * n + k] /= v0;
+        tau[k] = -v0 / alpha;
+        h[k * n + k] = alpha;
+
+        // A[k:, k+1:] -= tau * v * (v^T A[k:, k+1:])
+        std::fill(w.begin() + k + 1, w.end(), 0.0);
+        for (size_t c = k + 1; c < n; ++c) w[c] = h[k * n + c];
+        for (size_t r = k + 1; r < m; ++r) {
+            const double vr = h[r * n + k];
+            for (size_t c = k + 1; c < n; ++c) w[c] += vr * h[r * n + c];
+        }
+        for (size_t c = k + 1; c < n; ++c) h[k * n + c] -= tau[k] * w[c];
+        for (size_t r = k + 1; r < m; ++r) {
+            const double vr = tau[k] * h[r * n + k];
+            for (size_t c = k + 1; c < n; ++c) h[r * n + c] -= vr * w[c];
+        }
+    }
+
+    QR result{Matrix(m, n), Matrix(n, n)};
+    double* R = result.R.data();
+    for (size_t i = 0; i < n; ++i)
+        for (size_t j = i; j < n; ++j) R[i * n + j] = h[i * n + j];
+
+    // Q = H_0 H_1 ... H_{n-1} [I; 0], accumulated backwards
+    double* Q = result.Q.data();
+    for (size_t i = 0; i < n; ++i) Q[i * n + i] = 1.0;
+    for (size_t k = n; k-- > 0;) {
+        if (tau[k] == 0.0) continue;
+        std::fill(w.begin() + k, w.end(), 0.0);
+        for (size_t c = k; c < n; ++c) w[c] = Q[k * n + c];
+        for (size_t r = k + 1; r < m; ++r) {
+            const double vr = h[r * n + k];
+            for (size_t c = k; c < n; ++c) w[c] += vr * Q[r * n + c];
+        }
+        for (size_t c = k; c < n; ++c) Q[k * n + c] -= tau[k] * w[c];
+        for (size_t r = k + 1; r < m; ++r) {
+            const double vr = tau[k] * h[r * n + k];
+            for (size_t c = k; c < n; ++c) Q[r * n + c] -= vr * w[c];
+        }
+    }
+    return result;
+}
+
+Decomposition::SVD Decomposition::randomized_svd(const Matrix& A, size_t rank, const RandomizedSVDOptions& options) {
+    const size_t m = A.rows(), n = A.cols();
+    if (rank == 0 || rank > std::min(m, n))
+        throw std::invalid_argument("Rank must be between 1 and min(rows, cols)");
+
+    const size_t l = std::min(rank + options.oversampling, std::min(m, n));
+    std::mt19937_64 rng(options.seed);
+
+    // Range finder: Q spans the dominant column space of A
+    Matrix Q = qr(A * gaussian_matrix(n, l, rng)).Q;
+    for (size_t it = 0; it < options.power_iterations; ++it) {
+        const Matrix Z = qr(A.transpose_multiply(Q)).Q;
+        Q = qr(A * Z).Q;
+    }
+
+    // B = Q^T A is small (l x n); its SVD lifts to A through U = Q * U_B
+    Matrix B = A.transpose_multiply(Q).transpose();
+    Matrix UB = Matrix::identity(l);
+    one_sided_jacobi(B, UB);
+
+    std::vector<double> sigma(l);
+    const double* b = B.data();
+    for (size_t i = 0; i < l; ++i) {
+        double s = 0.0;
+        for (size_t c = 0; c < n; ++c) s += b[i * n + c] * b[i * n + c];
+        sigma[i] = std::sqrt(s);
+    }
+    std::vector<size_t> order(l);
+    std::iota(order.begin(), order.end(), size_t{0});
+    std::stable_sort(order.begin(), order.end(), [&](size_t x, size_t y) { return sigma[x] > sigma[y]; });
+
+    Matrix UBk(l, rank);
+    SVD result{Matrix(m, rank), std::vector<double>(rank), Matrix(rank, n)};
+    double* vt = result.Vt.data();
+    for (size_t c = 0; c < rank; ++c) {
+        const size_t idx = order[c];
+        result.singular_values[c] = sigma[idx];
+        const double inv = sigma[idx] > 0.0 ? 1.0 / sigma[idx] : 0.0;
+        for (size_t j = 0; j < n; ++j) vt[c * n + j] = b[idx * n + j] * inv;
+        for (size_t r = 0; r < l; ++r) UBk(r, c) = UB(r, idx);
+    }
+    result.U = Q * UBk;
+    return result;
+}
+
+} // namespace imeth
@@ -0,0 +1,361 @@
+#include "../include/imeth/linear/eigen.hpp"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <numeric>
+#include <random>
+#include <stdexcept>
+
+namespace imeth {
+
+namespace {
+
+constexpr double EPS = std::numeric_limits<double>::epsilon();
+
+double dot(const double* a, const double* b, size_t n) {
+    double s0 = 0.0, s1 = 0.0, s2 = 0.0, s3 = 0.0;
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        s0 += a[i] * b[i];
+        s1 += a[i + 1] * b[i + 1];
+        s2 += a[i + 2] * b[i + 2];
+        s3 += a[i + 3] * b[i + 3];
+    }
+    for (; i < n; ++i) s0 += a[i] * b[i];
+    return (s0 + s1) + (s2 + s3);
+}
+
+void axpy(double alpha, const double* x, double* y, size_t n) {
+    for (size_t i = 0; i < n; ++i) y[i] += alpha * x[i];
+}
+
+double normalize(std::vector<double>& v) {
+    const double norm = std::sqrt(dot(v.data(), v.data(), v.size()));
+    if (norm > 0.0)
+        for (double& x : v) x /= norm;
+    return norm;
+}
+
+std::vector<double> random_unit_vector(size_t n, std::mt19937_64& rng) {
+    std::normal_distribution<double> dist;
+    std::vector<double> v(n);
+    for (double& x : v) x = dist(rng);
+    normalize(v);
+    return v;
+}
+
+EigenSolver::MatVec dense_operator(const Matrix& A) {
+    if (A.rows() != A.cols())
+        throw std::invalid_argument("Matrix must be square");
+    return [&A](std::span<const double> x, std::span<double> y) {
+        const size_t n = A.rows();
+        const double* a = A.data();
+        for (size_t i = 0; i < n; ++i)
+            y[i] = dot(a + i * n, x.data(), n);
+    };
+}
+
+EigenSolver::MatVec sparse_operator(const SparseMatrix& A) {
+    if (A.rows() != A.cols())
+        throw std::invalid_argument("Matrix must be square");
+    return [&A](std::span<const double> x, std::span<double> y) { A.multiply(x, y); };
+}
+
+// Implicit QL on a symmetric tridiagonal matrix. d: diagonal (becomes eigenvalues),
+// e[i]: coupling between i and i+1. z (m x m, row-major) receives eigenvectors as columns.
+void tridiagonal_ql(std::vector<double>& d, std::vector<double> e, std::vector<double>& z) {
+    const size_t m = d.size();
+    e.resize(m, 0.0);
+    z.assign(m * m, 0.0);
+    for (size_t i = 0; i < m; ++i) z[i * m + i] = 1.0;
+
+    for (size_t l = 0; l < m; ++l) {
+        int iter = 0;
+        size_t s;
+        do {
+            for (s = l; s + 1 < m; ++s) {
+                const double dd = std::abs(d[s]) + std::abs(d[s + 1]);
+                if (std::abs(e[s]) <= EPS * dd) break;
+            }
+            if (s == l) break;
+            if (++iter > 60)
+                throw std::runtime_error("Tridiagonal eigenvalue iteration did not converge");
+
+            double g = (d[l + 1] - d[l]) / (2.0 * e[l]);
+            double r = std::hypot(g, 1.0);
+            g = d[s] - d[l] + e[l] / (g + std::copysign(r, g));
+            double sn = 1.0, cs = 1.0, p = 0.0;
+            bool deflated = false;
+            for (size_t i = s; i-- > l;) {
+                const double f = sn * e[i];
+                const double b = cs * e[i];
+                r = std::hypot(f, g);
+                e[i + 1] = r;
+                if (r == 0.0) {
+                    d[i + 1] -= p;
+                    e[s] = 0.0;
+                    deflated = true;
+                    break;
+                }
+                sn = f / r;
+                cs = g / r;
+                g = d[i + 1] - p;
+                r = (d[i] - g) * sn + 2.0 * cs * b;
+                p = sn * r;
+                d[i + 1] = g + p;
+                g = cs * r - b;
+                for (size_t k = 0; k < m; ++k) {
+                    const double t = z[k * m + i + 1];
+                    z[k * m + i + 1] = sn * z[k * m + i] + cs * t;
+                    z[k * m + i] = cs * z[k * m + i] - sn * t;
+                }
+            }
+            if (deflated) continue;
+            d[l] -= p;
+            e[l] = g;
+            e[s] = 0.0;
+        } while (true);
+    }
+}
+
+std::vector<size_t> select_indices(const std::vector<double>& values, size_t k,
+                                   EigenSolver::Spectrum which) {
+    std::vector<size_t> idx(values.size());
+    std::iota(idx.begin(), idx.end(), size_t{0});
+    std::stable_sort(idx.begin(), idx.end(), [&](size_t a, size_t b) {
+        switch (which) {
+        case EigenSolver::Spectrum::Smallest: return values[a] < values[b];
+        case EigenSolver::Spectrum::LargestMagnitude: return std::abs(values[a]) > std::abs(values[b]);
+        default: return values[a] > values[b];
+        }
+    });
+    idx.resize(std::min(k, idx.size()));
+    return idx;
+}
+
+// Dense LU with partial pivoting, used for the shifted solves in inverse iteration
+class DenseLU {
+public:
+    explicit DenseLU(Matrix A) : m_lu(std::move(A)), m_n(m_lu.rows()), m_perm(m_n) {
+        std::iota(m_perm.begin(), m_perm.end(), size_t{0});
+        double* a = m_lu.data();
+        double scale = 0.0;
+        for (size_t i = 0; i < m_n * m_n; ++i) scale = std::max(scale, std::abs(a[i]));
+        const double tiny = std::max(scale, 1.0) * EPS;
+
+        for (size_t k = 0; k < m_n; ++k) {
+            size_t p = k;
+            for (size_t i = k + 1; i < m_n; ++i)
+                if (std::abs(a[i * m_n + k]) > std::abs(a[p * m_n + k])) p = i;
+            if (p != k) {
+                std::swap_ranges(a + k * m_n, a + (k + 1) * m_n, a + p * m_n);
+                std::swap(m_perm[k], m_perm[p]);
+            }
+            // An exactly singular pivot means the shift hit an eigenvalue; perturb it
+            if (std::abs(a[k * m_n + k]) < tiny) a[k * m_n + k] = tiny;
+
+            const double pivot = a[k * m_n + k];
+            for (size_t i = k + 1; i < m_n; ++i) {
+                const double factor = a[i * m_n + k] / pivot;
+                a[i * m_n + k] = factor;
+                if (factor != 0.0)
+                    axpy(-factor, a + k * m_n + k + 1, a + i * m_n + k + 1, m_n - k - 1);
+            }
+        }
+    }
+
+    void solve(const std::vector<double>& b, std::vector<double>& x) const {
+        const double* a = m_lu.data();
+        for (size_t i = 0; i < m_n; ++i)
+            x[i] = b[m_perm[i]] - dot(a + i * m_n, x.data(), i);
+        for (size_t i = m_n; i-- > 0;)
+            x[i] = (x[i] - dot(a + i * m_n + i + 1, x.data() + i + 1, m_n - i - 1)) / a[i * m_n + i];
+    }
+
+private:
+    Matrix m_lu;
+    size_t m_n;
+    std::vector<size_t> m_perm;
+};
+
+} // namespace
+
+EigenSolver::EigenPair EigenSolver::power_iteration(const MatVec& A, size_t n, const Options& options) {
+    if (n == 0)
+        throw std::invalid_argument("Operator dimension must be positive");
+
+    std::mt19937_64 rng(options.seed);
+    EigenPair result;
+    result.vector = random_unit_vector(n, rng);
+    std::vector<double> y(n);
+
+    for (size_t it = 1; it <= options.max_iterations; ++it) {
+        A(result.vector, y);
+        const double lambda = dot(result.vector.data(), y.data(), n);
+        result.value = lambda;
+        result.iterations = it;
+
+        double residual = 0.0;
+        for (size_t i = 0; i < n; ++i) {
+            const double r = y[i] - lambda * result.vector[i];
+            residual += r * r;
+        }
+        if (std::sqrt(residual) <= options.tolerance * std::max(std::abs(lambda), EPS)) {
+            result.converged = true;
+            break;
+        }
+
+        if (normalize(y) == 0.0) {
+            result.value = 0.0;
+            result.converged = true;
+            break;
+        }
+        result.vector.swap(y);
+    }
+    return result;
+}
+
+EigenSolver::EigenPair EigenSolver::power_iteration(const Matrix& A, const Options& options) {
+    return power_iteration(dense_operator(A), A.rows(), options);
+}
+
+EigenSolver::EigenPair EigenSolver::power_iteration(const SparseMatrix& A, const Options& options) {
+    return power_iteration(sparse_operator(A), A.rows(), options);
+}
+
+EigenSolver::EigenPair EigenSolver::inverse_iteration(const Matrix& A, double shift, const Options& options) {
+    const MatVec op = dense_operator(A);
+    const size_t n = A.rows();
+    if (n == 0)
+        throw std::invalid_argument("Operator dimension must be positive");
+
+    Matrix shifted = A;
+    for (size_t i = 0; i < n; ++i) shifted(i, i) -= shift;
+    const DenseLU lu(std::move(shifted));
+
+    std::mt19937_64 rng(options.seed);
+    EigenPair result;
+    result.vector = random_unit_vector(n, rng);
+    std::vector<double> y(n), Ay(n);
+
+    for (size_t it = 1; it <= options.max_iterations; ++it) {
+        lu.solve(result.vector, y);
+        normalize(y);
+        result.vector.swap(y);
+
+        op(result.vector, Ay);
+        const double lambda = dot(result.vector.data(), Ay.data(), n);
+        result.value = lambda;
+        result.iterations = it;
+
+        double residual = 0.0;
+        for (size_t i = 0; i < n; ++i) {
+            const double r = Ay[i] - lambda * result.vector[i];
+            residual += r * r;
+        }
+        if (std::sqrt(residual) <= options.tolerance * std::max(std::abs(lambda), EPS)) {
+            result.converged = true;
+            break;
+        }
+    }
+    return result;
+}
+
+EigenSolver::EigenPairs EigenSolver::lanczos(const MatVec& A, size_t n, size_t k, const Options& options) {
+    if (n == 0)
+        throw std::invalid_argument("Operator dimension must be positive");
+    if (k == 0 || k > n)
+        throw std::invalid_argument("Number of eigenpairs must be between 1 and n");
+
+    const size_t max_basis = std::min(n, std::max(options.max_iterations, k));
+    constexpr size_t check_interval = 5;
+
+    std::mt19937_64 rng(options.seed);
+    std::vector<double> basis = random_unit_vector(n, rng); // row j holds q_j
+    std::vector<double> alpha, beta;
+    std::vector<double> w(n), ritz, z;
+    std::vector<size_t> selected;
+    double anorm = 0.0;
+    bool converged = false;
+
+    for (size_t j = 0;; ++j) {
+        const double* q = basis.data() + j * n;
+        A(std::span<const double>(q, n), w);
+
+        const double a = dot(q, w.data(), n);
+        alpha.push_back(a);
+        axpy(-a, q, w.data(), n);
+        if (j > 0) axpy(-beta[j - 1], q - n, w.data(), n);
+
+        // Full reorthogonalization; the second pass restores orthogonality lost to cancellation
+        for (int pass = 0; pass < 2; ++pass)
+            for (size_t i = 0; i <= j; ++i) {
+                const double* qi = basis.data() + i * n;
+                axpy(-dot(qi, w.data(), n), qi, w.data(), n);
+            }
+
+        const double b = std::sqrt(dot(w.data(), w.data(), n));
+        const size_t m = j + 1;
+        anorm = std::max(anorm, std::abs(a) + b + (j > 0 ? beta[j - 1] : 0.0));
+        const bool invariant = b <= anorm * EPS * 16;
+
+        const bool last = m == max_basis;
+        if (m >= k && (last || (!invariant && (m - k) % check_interval == 0))) {
+            ritz = alpha;
+            tridiagonal_ql(ritz, beta, z);
+            selected = select_indices(ritz, k, options.which);
+
+            converged = true;
+            for (size_t idx : selected) {
+                const double residual = std::abs(b * z[(m - 1) * m + idx]);
+                if (residual > options.tolerance * std::max(std::abs(ritz[idx]), anorm * EPS)) {
+                    converged = false;
+                    break;
+                }
+            }
+            if (converged || last) break;
+        }
+
+        // Extend the basis; after an invariant subspace restart from a fresh orthogonal direction
+        if (invariant) {
+            std::vector<double> v = random_unit_vector(n, rng);
+            for (int pass = 0; pass < 2; ++pass)
+                for (size_t i = 0; i <= j; ++i) {
+                    const double* qi = basis.data() + i * n;
+                    axpy(-dot(qi, v.data(), n), qi, v.data(), n);
+                }
+            normalize(v);
+            beta.push_back(0.0);
+            basis.insert(basis.end(), v.begin(), v.end());
+        } else {
+            beta.push_back(b);
+            for (double& x : w) x /= b;
+            basis.insert(basis.end(), w.begin(), w.end());
+        }
+    }
+
+    const size_t m = alpha.size();
+    EigenPairs result{{}, Matrix(n, k), m, converged};
+    double* v = result.vectors.data();
+    for (size_t c = 0; c < k; ++c) {
+        const size_t idx = selected[c];
+        result.values.push_back(ritz[idx]);
+        for (size_t j = 0; j < m; ++j) {
+            const double coeff = z[j * m + idx];
+            const double* qj = basis.data() + j * n;
+            for (size_t i = 0; i < n; ++i)
+                v[i * k + c] += coeff * qj[i];
+        }
+    }
+    return result;
+}
+
+EigenSolver::EigenPairs EigenSolver::lanczos(const Matrix& A, size_t k, const Options& options) {
+    return lanczos(dense_operator(A), A.rows(), k, options);
+}
+
+EigenSolver::EigenPairs EigenSolver::lanczos(const SparseMatrix& A, size_t k, const Options& options) {
+    return lanczos(sparse_operator(A), A.rows(), k, options);
+}
+
+} // namespace imeth
@@ -1,9 +1,131 @@
 #include "../include/imeth/linear/matrix.hpp"
 #include "../include/imeth/operation/arithmetic.hpp"
+#include "../detail/parallel.hpp"
+#include <algorithm>
+#include <cmath>
 #include <stdexcept>
+#include <string>
 
 namespace imeth {
 
+namespace {
+
+// Cache blocking for the GEMM kernels below; a KC x NC panel of B stays in L2
+constexpr size_t MC = 64;
+constexpr size_t KC = 256;
+constexpr size_t NC = 1024;
+// Below this many multiply-adds threads cost more than they save
+constexpr size_t PARALLEL_FLOPS = 1u << 18;
+
+size_t row_grain(size_t rows, size_t flops_per_row) {
+    const size_t min_rows = PARALLEL_FLOPS / std::max<size_t>(flops_per_row, 1) + 1;
+    return std::max(min_rows, std::min<size_t>(MC, rows));
+}
+
+// C (m x p) += A (m x n) * B (n x p), all row-major
+void gemm_nn(const double* A, const double* B, double* C, size_t m, size_t n, size_t p) {
+    detail::parallel_for(0, m, row_grain(m, n * p), [=](size_t r0, size_t r1) {
+        for (size_t jj = 0; jj < p; jj += NC) {
+            const size_t jn = std::min(NC, p - jj);
+            for (size_t kk = 0; kk < n; kk += KC) {
+                const size_t kn = std::min(KC, n - kk);
+                for (size_t ii = r0; ii < r1; ii += MC) {
+                    const size_t iend = std::min(ii + MC, r1);
+                    for (size_t i = ii; i < iend; ++i) {
+                        double* c = C + i * p + jj;
+                        for (size_t k = kk; k < kk + kn; ++k) {
+                            const double a = A[i * n + k];
+                            const double* b = B + k * p + jj;
+                            for (size_t j = 0; j < jn; ++j)
+                                c[j] += a * b[j];
+                        }
+                    }
+                }
+            }
+        }
+    });
+}
+
+// C (m x p) += A^T * B with A (n x m) and B (n x p), all row-major
+void gemm_tn(const double* A, const double* B, double* C, size_t m, size_t n, size_t p) {
+    detail::parallel_for(0, m, row_grain(m, n * p), [=](size_t r0, size_t r1) {
+        for (size_t jj = 0; jj < p; jj += NC) {
+            const size_t jn = std::min(NC, p - jj);
+            for (size_t kk = 0; kk < n; kk += KC) {
+                const size_t kend = std::min(kk + KC, n);
+                for (size_t i = r0; i < r1; ++i) {
+                    double* c = C + i * p + jj;
+                    for (size_t k = kk; k < kend; ++k) {
+                        const double a = A[k * m + i];
+                        const double* b = B + k * p + jj;
+                        for (size_t j = 0; j < jn; ++j)
+                            c[j] += a * b[j];
+                    }
+                }
+            }
+        }
+    });
+}
+
+// C (m x p) += A * B^T with A (m x n) and B (p x n), all row-major
+void gemm_nt(const double* A, const double* B, double* C, size_t m, size_t n, size_t p) {
+    detail::parallel_for(0, m, row_grain(m, n * p), [=](size_t r0, size_t r1) {
+        for (size_t i = r0; i < r1; ++i) {
+            const double* a = A + i * n;
+            for (size_t j = 0; j < p; ++j) {
+                const double* b = B + j * n;
+                double s0 = 0.0, s1 = 0.0, s2 = 0.0, s3 = 0.0;
+                size_t k = 0;
+                for (; k + 4 <= n; k += 4) {
+                    s0 += a[k] * b[k];
+                    s1 += a[k + 1] * b[k + 1];
+                    s2 += a[k + 2] * b[k + 2];
+                    s3 += a[k + 3] * b[k + 3];
+                }
+                for (; k < n; ++k) s0 += a[k] * b[k];
+                C[i * p + j] += (s0 + s1) + (s2 + s3);
+            }
+        }
+    });
+}
+
+// Solves a x = rhs in place: a (n x n, row-major) is overwritten by its LU factors and
+// rhs by the solution. Returns false for a singular matrix.
+bool lu_solve_in_place(double* a, double* rhs, size_t n) {
+    for (size_t k = 0; k < n; ++k) {
+        size_t p = k;
+        for (size_t i = k + 1; i < n; ++i)
+            if (std::abs(a[i * n + k]) > std::abs(a[p * n + k])) p = i;
+        if (std::abs(a[p * n + k]) < 1e-12) return false;
+        if (p != k) {
+            std::swap_ranges(a + k * n, a + (k + 1) * n, a + p * n);
+            std::swap(rhs[k], rhs[p]);
+        }
+
+        const double inv = 1.0 / a[k * n + k];
+        const double* pivot_row = a + k * n;
+        for (size_t i = k + 1; i < n; ++i) {
+            double* row = a + i * n;
+            const double factor = row[k] * inv;
+            if (factor == 0.0) continue;
+            for (size_t j = k + 1; j < n; ++j)
+                row[j] -= factor * pivot_row[j];
+            rhs[i] -= factor * rhs[k];
+        }
+    }
+
+    for (size_t i = n; i-- > 0;) {
+        const double* row = a + i * n;
+        double acc = rhs[i];
+        for (size_t j = i + 1; j < n; ++j)
+            acc -= row[j] * rhs[j];
+        rhs[i] = acc / row[i];
+    }
+    return true;
+}
+
+} // namespace
+
 Matrix::Matrix(size_t rows, size_t cols)
     : m_data(rows * cols, 0.0), m_rows(rows), m_cols(cols) {}
 
@@ -33,6 +155,9 @@ double Matrix::operator()(size_t r, size_t c) const {
 size_t Matrix::rows() const { return m_rows; }
 size_t Matrix::cols() const { return m_cols; }
 
+double* Matrix::data() { return m_data.data(); }
+const double* Matrix::data() const { return m_data.data(); }
+
 Matrix Matrix::identity(size_t n) {
     Matrix I(n, n);
     for (size_t i = 0; i < n; ++i)
@@ -53,10 +178,25 @@ Matrix Matrix::operator*(const Matrix& rhs) const {
         throw std::invalid_argument("Matrix dimensions mismatch for multiplication");
 
     Matrix result(m_rows, rhs.m_cols);
-    for (size_t i = 0; i < m_rows; ++i)
-        for (size_t j = 0; j < rhs.m_cols; ++j)
-            for (size_t k = 0; k < m_cols; ++k)
-                result(i, j) += (*this)(i, k) * rhs(k, j);
+    gemm_nn(m_data.data(), rhs.m_data.data(), result.m_data.data(), m_rows, m_cols, rhs.m_cols);
+    return result;
+}
+
+Matrix Matrix::transpose_multiply(const Matrix& rhs) const {
+    if (m_rows != rhs.m_rows)
+        throw std::invalid_argument("Matrix dimensions mismatch for multiplication");
+
+    Matrix result(m_cols, rhs.m_cols);
+    gemm_tn(m_data.data(), rhs.m_data.data(), result.m_data.data(), m_cols, m_rows, rhs.m_cols);
+    return result;
+}
+
+Matrix Matrix::multiply_transpose(const Matrix& rhs) const {
+    if (m_cols != rhs.m_cols)
+        throw std::invalid_argument("Matrix dimensions mismatch for multiplication");
+
+    Matrix result(m_rows, rhs.m_rows);
+    gemm_nt(m_data.data(), rhs.m_data.data(), result.m_data.data(), m_rows, m_cols, rhs.m_rows);
     return result;
 }
 
@@ -86,6 +226,8 @@ Vector::Vector(std::initializer_list<double> data) : m_data(data) {}
 double& Vector::operator[](size_t i) { return m_data.at(i); }
 double Vector::operator[](size_t i) const { return m_data.at(i); }
 size_t Vector::size() const { return m_data.size(); }
+double* Vector::data() { return m_data.data(); }
+const double* Vector::data() const { return m_data.data(); }
 
 Vector Solver::gaussian_elimination(const Matrix& A, const Vector& b) {
     size_t n = A.rows();
@@ -183,4 +325,42 @@ Vector Solver::lu_decomposition(const Matrix& A, const Vector& b) {
     return x;
 }
 
-} // namespace imeth
\ No newline at end of file
+std::vector<Vector> Solver::batch_solve(const std::vector<std::pair<Matrix, Vector>>& systems) {
+    for (const auto& [A, b] : systems)
+        if (A.rows() != A.cols() || b.size() != A.rows())
+            throw std::invalid_argument("Matrix and vector dimension mismatch");
+
+    std::vector<Vector> results;
+    results.reserve(systems.size());
+    for (const auto& system : systems)
+        results.push_back(system.second);
+
+    const unsigned workers = detail::worker_count(systems.size());
+    std::vector<std::vector<double>> workspaces(workers);
+    detail::work_stealing_for(systems.size(), workers, [&](unsigned w, size_t i) {
+        const Matrix& A = systems[i].first;
+        auto& ws = workspaces[w];
+        ws.assign(A.data(), A.data() + A.rows() * A.cols());
+        if (!lu_solve_in_place(ws.data(), results[i].data(), A.rows()))
+            throw std::runtime_error("Singular matrix in batch system " + std::to_string(i));
+    });
+    return results;
+}
+
+void Solver::batch_solve(std::span<const double> A, std::span<const double> b, std::span<double> x, size_t n) {
+    if (n == 0 || b.size() % n != 0 || x.size() != b.size() || A.size() != b.size() * n)
+        throw std::invalid_argument("Matrix and vector dimension mismatch");
+
+    const size_t count = b.size() / n;
+    const unsigned workers = detail::worker_count(count);
+    std::vector<std::vector<double>> workspaces(workers, std::vector<double>(n * n));
+    detail::work_stealing_for(count, workers, [&](unsigned w, size_t i) {
+        auto& ws = workspaces[w];
+        std::copy_n(A.begin() + i * n * n, n * n, ws.begin());
+        std::copy_n(b.begin() + i * n, n, x.begin() + i * n);
+        if (!lu_solve_in_place(ws.data(), x.data() + i * n, n))
+            throw std::runtime_error("Singular matrix in batch system " + std::to_string(i));
+    });
+}
+
+} // namespace imeth
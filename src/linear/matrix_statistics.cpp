@@ -0,0 +1,198 @@
+#include "../include/imeth/linear/matrix_statistics.hpp"
+#include "../detail/parallel.hpp"
+#include "../detail/selection.hpp"
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+namespace imeth {
+
+namespace {
+
+// Below this many elements a reduction stays on the calling thread
+constexpr size_t PARALLEL_ELEMENTS = 1u << 15;
+// Columns processed together, keeps the per-column state of a block in L1
+constexpr size_t COLUMN_BLOCK = 256;
+
+struct Partial {
+    size_t count{};
+    std::vector<double> sum, mean, m2, min, max;
+};
+
+// Welford update vectorized across columns: every column sees the same row count, so the
+// reciprocal is shared and the inner loop is a straight SIMD sweep over one row
+Partial accumulate_rows(const double* data, size_t cols, size_t r0, size_t r1) {
+    Partial p;
+    p.count = r1 - r0;
+    const double* first = data + r0 * cols;
+    p.sum.assign(first, first + cols);
+    p.mean = p.sum;
+    p.min = p.sum;
+    p.max = p.sum;
+    p.m2.assign(cols, 0.0);
+
+    for (size_t cb = 0; cb < cols; cb += COLUMN_BLOCK) {
+        const size_t ce = std::min(cb + COLUMN_BLOCK, cols);
+        double* sum = p.sum.data();
+        double* mean = p.mean.data();
+        double* m2 = p.m2.data();
+        double* mn = p.min.data();
+        double* mx = p.max.data();
+        for (size_t r = r0 + 1; r < r1; ++r) {
+            const double inv = 1.0 / static_cast<double>(r - r0 + 1);
+            const double* row = data + r * cols;
+            for (size_t c = cb; c < ce; ++c) {
+                const double x = row[c];
+                const double delta = x - mean[c];
+                sum[c] += x;
+                mean[c] += delta * inv;
+                m2[c] += delta * (x - mean[c]);
+                mn[c] = x < mn[c] ? x : mn[c];
+                mx[c] = x > mx[c] ? x : mx[c];
+            }
+        }
+    }
+    return p;
+}
+
+// Chan et al. pairwise combination of two partial Welford states
+void merge(Partial& into, const Partial& from) {
+    const double na = static_cast<double>(into.count);
+    const double nb = static_cast<double>(from.count);
+    const double n = na + nb;
+    for (size_t c = 0; c < into.sum.size(); ++c) {
+        const double delta = from.mean[c] - into.mean[c];
+        into.mean[c] += delta * nb / n;
+        into.m2[c] += from.m2[c] + delta * delta * na * nb / n;
+        into.sum[c] += from.sum[c];
+        into.min[c] = std::min(into.min[c], from.min[c]);
+        into.max[c] = std::max(into.max[c], from.max[c]);
+    }
+    into.count += from.count;
+}
+
+void require_nonempty(const Matrix& M) {
+    if (M.rows() == 0 || M.cols() == 0)
+        throw std::invalid_argument("Cannot compute statistics of an empty matrix");
+}
+
+std::vector<double> first_row(const Matrix& Q) {
+    return std::vector<double>(Q.data(), Q.data() + Q.cols());
+}
+
+} // namespace
+
+MatrixStatistics::Summary MatrixStatistics::describe_columns(const Matrix& M) {
+    require_nonempty(M);
+    const size_t rows = M.rows(), cols = M.cols();
+
+    const size_t chunks = std::clamp<size_t>(rows * cols / PARALLEL_ELEMENTS, 1, std::min<size_t>(detail::thread_count(), rows));
+    std::vector<Partial> partials(chunks);
+    detail::parallel_for(0, chunks, 1, [&](size_t lo, size_t hi) {
+        for (size_t c = lo; c < hi; ++c)
+            partials[c] = accumulate_rows(M.data(), cols, rows * c / chunks, rows * (c + 1) / chunks);
+    });
+    for (size_t c = 1; c < chunks; ++c)
+        merge(partials[0], partials[c]);
+
+    Partial& p = partials[0];
+    for (double& m2 : p.m2) m2 /= static_cast<double>(rows);
+    return Summary{rows, std::move(p.sum), std::move(p.mean), std::move(p.m2), std::move(p.min), std::move(p.max)};
+}
+
+MatrixStatistics::Summary MatrixStatistics::describe_rows(const Matrix& M) {
+    require_nonempty(M);
+    const size_t rows = M.rows(), cols = M.cols();
+    Summary s{cols, std::vector<double>(rows), std::vector<double>(rows), std::vector<double>(rows),
+              std::vector<double>(rows), std::vector<double>(rows)};
+
+    const size_t grain = PARALLEL_ELEMENTS / cols + 1;
+    detail::parallel_for(0, rows, grain, [&](size_t r0, size_t r1) {
+        for (size_t r = r0; r < r1; ++r) {
+            // The row is contiguous and stays cached, so an exact two-pass variance is cheap
+            const double* row = M.data() + r * cols;
+            double sum = 0.0, mn = row[0], mx = row[0];
+            for (size_t c = 0; c < cols; ++c) {
+                sum += row[c];
+                mn = row[c] < mn ? row[c] : mn;
+                mx = row[c] > mx ? row[c] : mx;
+            }
+            const double mean = sum / static_cast<double>(cols);
+            double m2 = 0.0;
+            for (size_t c = 0; c < cols; ++c)
+                m2 += (row[c] - mean) * (row[c] - mean);
+
+            s.sum[r] = sum;
+            s.average[r] = mean;
+            s.variance[r] = m2 / static_cast<double>(cols);
+            s.minimum[r] = mn;
+            s.maximum[r] = mx;
+        }
+    });
+    return s;
+}
+
+std::vector<double> MatrixStatistics::column_sum(const Matrix& M) { return describe_columns(M).sum; }
+std::vector<double> MatrixStatistics::column_average(const Matrix& M) { return describe_columns(M).average; }
+std::vector<double> MatrixStatistics::column_variance(const Matrix& M) { return describe_columns(M).variance; }
+std::vector<double> MatrixStatistics::column_minimum(const Matrix& M) { return describe_columns(M).minimum; }
+std::vector<double> MatrixStatistics::column_maximum(const Matrix& M) { return describe_columns(M).maximum; }
+
+std::vector<double> MatrixStatistics::row_sum(const Matrix& M) { return describe_rows(M).sum; }
+std::vector<double> MatrixStatistics::row_average(const Matrix& M) { return describe_rows(M).average; }
+std::vector<double> MatrixStatistics::row_variance(const Matrix& M) { return describe_rows(M).variance; }
+std::vector<double> MatrixStatistics::row_minimum(const Matrix& M) { return describe_rows(M).minimum; }
+std::vector<double> MatrixStatistics::row_maximum(const Matrix& M) { return describe_rows(M).maximum; }
+
+Matrix MatrixStatistics::column_quantiles(const Matrix& M, const std::vector<double>& probabilities) {
+    require_nonempty(M);
+    detail::validate_quantile_arguments(M.rows(), probabilities);
+    const size_t rows = M.rows(), cols = M.cols();
+    Matrix Q(probabilities.size(), cols);
+
+    // Columns are gathered eight at a time so each pass over the rows uses whole cache lines
+    constexpr size_t GATHER = 8;
+    const size_t blocks = (cols + GATHER - 1) / GATHER;
+    detail::parallel_for(0, blocks, 1, [&](size_t b0, size_t b1) {
+        std::vector<std::vector<double>> buffers(GATHER, std::vector<double>(rows));
+        for (size_t b = b0; b < b1; ++b) {
+            const size_t c0 = b * GATHER, width = std::min(GATHER, cols - c0);
+            for (size_t r = 0; r < rows; ++r) {
+                const double* row = M.data() + r * cols + c0;
+                for (size_t w = 0; w < width; ++w) buffers[w][r] = row[w];
+            }
+            for (size_t w = 0; w < width; ++w) {
+                const auto q = detail::quantiles_in_place(buffers[w].data(), rows, probabilities);
+                for (size_t i = 0; i < q.size(); ++i) Q(i, c0 + w) = q[i];
+            }
+        }
+    });
+    return Q;
+}
+
+Matrix MatrixStatistics::row_quantiles(const Matrix& M, const std::vector<double>& probabilities) {
+    require_nonempty(M);
+    detail::validate_quantile_arguments(M.cols(), probabilities);
+    const size_t rows = M.rows(), cols = M.cols();
+    Matrix Q(probabilities.size(), rows);
+
+    detail::parallel_for(0, rows, PARALLEL_ELEMENTS / cols + 1, [&](size_t r0, size_t r1) {
+        std::vector<double> buffer;
+        for (size_t r = r0; r < r1; ++r) {
+            buffer.assign(M.data() + r * cols, M.data() + (r + 1) * cols);
+            const auto q = detail::quantiles_in_place(buffer.data(), cols, probabilities);
+            for (size_t i = 0; i < q.size(); ++i) Q(i, r) = q[i];
+        }
+    });
+    return Q;
+}
+
+std::vector<double> MatrixStatistics::column_median(const Matrix& M) {
+    return first_row(column_quantiles(M, {0.5}));
+}
+
+std::vector<double> MatrixStatistics::row_median(const Matrix& M) {
+    return first_row(row_quantiles(M, {0.5}));
+}
+
+} // namespace imeth
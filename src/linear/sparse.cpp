@@ -0,0 +1,141 @@
+#include "../include/imeth/linear/sparse.hpp"
+#include "../include/imeth/linear/matrix.hpp"
+#include <algorithm>
+#include <stdexcept>
+
+namespace imeth {
+
+SparseMatrix::SparseMatrix(size_t rows, size_t cols)
+    : m_rows(rows), m_cols(cols), m_row_offsets(rows + 1, 0) {}
+
+SparseMatrix::SparseMatrix(size_t rows, size_t cols, const std::vector<Triplet>& entries)
+    : m_rows(rows), m_cols(cols), m_row_offsets(rows + 1, 0) {
+    for (const auto& e : entries) {
+        if (e.row >= rows || e.col >= cols)
+            throw std::out_of_range("Sparse matrix entry out of range");
+        ++m_row_offsets[e.row + 1];
+    }
+    for (size_t r = 0; r < rows; ++r)
+        m_row_offsets[r + 1] += m_row_offsets[r];
+
+    // Bucket by row, then sort each row by column and merge duplicates
+    std::vector<size_t> next(m_row_offsets.begin(), m_row_offsets.end() - 1);
+    std::vector<size_t> cols_tmp(entries.size());
+    std::vector<double> vals_tmp(entries.size());
+    for (const auto& e : entries) {
+        const size_t dst = next[e.row]++;
+        cols_tmp[dst] = e.col;
+        vals_tmp[dst] = e.value;
+    }
+
+    m_column_indices.reserve(entries.size());
+    m_values.reserve(entries.size());
+    std::vector<size_t> order;
+    size_t written = 0;
+    for (size_t r = 0; r < rows; ++r) {
+        const size_t begin = m_row_offsets[r], end = m_row_offsets[r + 1];
+        order.resize(end - begin);
+        for (size_t i = 0; i < order.size(); ++i) order[i] = begin + i;
+        std::sort(order.begin(), order.end(),
+                  [&](size_t a, size_t b) { return cols_tmp[a] < cols_tmp[b]; });
+
+        m_row_offsets[r] = written;
+        for (size_t idx : order) {
+            if (written > m_row_offsets[r] && m_column_indices.back() == cols_tmp[idx]) {
+                m_values.back() += vals_tmp[idx];
+            } else {
+                m_column_indices.push_back(cols_tmp[idx]);
+                m_values.push_back(vals_tmp[idx]);
+                ++written;
+            }
+        }
+    }
+    m_row_offsets[rows] = written;
+}
+
+SparseMatrix SparseMatrix::from_dense(const Matrix& dense, double drop_tolerance) {
+    std::vector<Triplet> entries;
+    for (size_t i = 0; i < dense.rows(); ++i)
+        for (size_t j = 0; j < dense.cols(); ++j) {
+            const double v = dense(i, j);
+            if (v > drop_tolerance || v < -drop_tolerance)
+                entries.push_back({i, j, v});
+        }
+    return SparseMatrix(dense.rows(), dense.cols(), entries);
+}
+
+SparseMatrix SparseMatrix::identity(size_t n) {
+    std::vector<Triplet> entries;
+    entries.reserve(n);
+    for (size_t i = 0; i < n; ++i)
+        entries.push_back({i, i, 1.0});
+    return SparseMatrix(n, n, entries);
+}
+
+size_t SparseMatrix::rows() const { return m_rows; }
+size_t SparseMatrix::cols() const { return m_cols; }
+size_t SparseMatrix::nonzeros() const { return m_values.size(); }
+
+double SparseMatrix::operator()(size_t r, size_t c) const {
+    if (r >= m_rows || c >= m_cols)
+        throw std::out_of_range("Matrix index out of range");
+    const auto first = m_column_indices.begin() + m_row_offsets[r];
+    const auto last = m_column_indices.begin() + m_row_offsets[r + 1];
+    const auto it = std::lower_bound(first, last, c);
+    if (it == last || *it != c) return 0.0;
+    return m_values[it - m_column_indices.begin()];
+}
+
+const std::vector<size_t>& SparseMatrix::row_offsets() const { return m_row_offsets; }
+const std::vector<size_t>& SparseMatrix::column_indices() const { return m_column_indices; }
+const std::vector<double>& SparseMatrix::values() const { return m_values; }
+std::vector<double>& SparseMatrix::values() { return m_values; }
+
+void SparseMatrix::multiply(std::span<const double> x, std::span<double> y) const {
+    if (x.size() != m_cols || y.size() != m_rows)
+        throw std::invalid_argument("Matrix and vector dimension mismatch");
+
+    for (size_t r = 0; r < m_rows; ++r) {
+        double acc = 0.0;
+        for (size_t k = m_row_offsets[r]; k < m_row_offsets[r + 1]; ++k)
+            acc += m_values[k] * x[m_column_indices[k]];
+        y[r] = acc;
+    }
+}
+
+std::vector<double> SparseMatrix::operator*(const std::vector<double>& x) const {
+    std::vector<double> y(m_rows);
+    multiply(x, y);
+    return y;
+}
+
+SparseMatrix SparseMatrix::transpose() const {
+    SparseMatrix t(m_cols, m_rows);
+    t.m_column_indices.resize(nonzeros());
+    t.m_values.resize(nonzeros());
+
+    for (size_t c : m_column_indices)
+        ++t.m_row_offsets[c + 1];
+    for (size_t c = 0; c < m_cols; ++c)
+        t.m_row_offsets[c + 1] += t.m_row_offsets[c];
+
+    std::vector<size_t> next(t.m_row_offsets.begin(), t.m_row_offsets.end() - 1);
+    for (size_t r = 0; r < m_rows; ++r)
+        for (size_t k = m_row_offsets[r]; k < m_row_offsets[r + 1]; ++k) {
+            const size_t dst = next[m_column_indices[k]]++;
+            t.m_column_indices[dst] = r;
+            t.m_values[dst] = m_values[k];
+        }
+    return t;
+}
+
+Matrix SparseMatrix::to_dense() const {
+    Matrix dense(m_rows, m_cols);
+    double* out = dense.data();
+    for (size_t r = 0; r < m_rows; ++r)
+        for (size_t k = m_row_offsets[r]; k < m_row_offsets[r + 1]; ++k)
+            out[r * m_cols + m_column_indices[k]] = m_values[k];
+    return dense;
+}
+
+} // namespace imeth
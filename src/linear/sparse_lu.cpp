@@ -0,0 +1,449 @@
+#include "../include/imeth/linear/sparse_lu.hpp"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <numeric>
+#include <stdexcept>
+
+namespace imeth {
+
+namespace {
+
+constexpr size_t NONE = std::numeric_limits<size_t>::max();
+
+// Approximate minimum degree ordering (Amestoy, Davis & Duff) on the graph of A + A^T.
+//
+// Eliminating a node would join its neighbours into a clique. Instead of adding those edges,
+// the quotient graph keeps the eliminated node as an element: a list of the variables the
+// clique spans. A variable is adjacent to other variables and to elements, and storage never
+// grows past the pattern of A. On top of that:
+// - degrees are upper bounds from element sizes, not exact sizes of clique unions;
+// - elements adjacent to the pivot, or contained in the new element, are absorbed into it;
+// - variables with identical adjacency are merged into one supervariable and eliminated
+//   together, so each pivot step removes as many of them at once as it can;
+// - nodes with more than 10 sqrt(n) neighbours are left out and ordered last.
+std::vector<size_t> minimum_degree(size_t n, const std::vector<size_t>& offsets,
+                                   const std::vector<size_t>& columns) {
+    enum State : char { Variable, Element, Absorbed };
+
+    // vars[i]: variable neighbours of variable i, or the variables of element i
+    std::vector<std::vector<size_t>> vars(n), elems(n);
+    for (size_t r = 0; r < n; ++r)
+        for (size_t p = offsets[r]; p < offsets[r + 1]; ++p) {
+            const size_t c = columns[p];
+            if (c == r) continue;
+            vars[r].push_back(c);
+            vars[c].push_back(r);
+        }
+    for (auto& a : vars) {
+        std::sort(a.begin(), a.end());
+        a.erase(std::unique(a.begin(), a.end()), a.end());
+    }
+
+    std::vector<State> state(n, Variable);
+    std::vector<size_t> weight(n, 1);  // variables in a supervariable; 0 once merged away
+    std::vector<std::vector<size_t>> members(n);  // variables merged into i, eliminated with it
+    std::vector<size_t> order, dense;
+    order.reserve(n);
+
+    const auto dense_degree = std::max<size_t>(16, static_cast<size_t>(10.0 * std::sqrt(static_cast<double>(n))));
+    for (size_t v = 0; v < n; ++v)
+        if (vars[v].size() > dense_degree) {
+            state[v] = Absorbed;
+            weight[v] = 0;
+            dense.push_back(v);
+        }
+    if (!dense.empty())
+        for (size_t v = 0; v < n; ++v)
+            std::erase_if(vars[v], [&](size_t u) { return state[u] != Variable; });
+
+    // Variables bucketed by approximate degree in doubly linked lists
+    std::vector<size_t> degree(n), head(n + 1, NONE), next(n, NONE), prev(n, NONE);
+    auto insert = [&](size_t v) {
+        next[v] = head[degree[v]];
+        prev[v] = NONE;
+        if (next[v] != NONE) prev[next[v]] = v;
+        head[degree[v]] = v;
+    };
+    auto remove = [&](size_t v) {
+        if (prev[v] != NONE) next[prev[v]] = next[v];
+        else head[degree[v]] = next[v];
+        if (next[v] != NONE) prev[next[v]] = prev[v];
+    };
+    size_t live = 0, min_degree = n;
+    for (size_t v = n; v-- > 0;) {
+        if (state[v] != Variable) continue;
+        degree[v] = vars[v].size();
+        min_degree = std::min(min_degree, degree[v]);
+        insert(v);
+        ++live;
+    }
+
+    std::vector<size_t> esize(n, 0);           // total weight of an element's variables
+    std::vector<size_t> in_pivot(n, NONE);     // step at which a variable joined the pivot element
+    std::vector<size_t> external(n), external_step(n, NONE);  // |Le \ Lp| at that step
+    std::vector<size_t> partial(n), hash(n), lp;
+    size_t eliminated = 0;
+    for (size_t step = 0; eliminated < live; ++step) {
+        while (head[min_degree] == NONE) ++min_degree;
+        const size_t p = head[min_degree];
+        remove(p);
+        order.push_back(p);
+        order.insert(order.end(), members[p].begin(), members[p].end());
+        eliminated += weight[p];
+
+        // Lp: the variables of p's elements and its variable neighbours; those elements are
+        // absorbed into p, which becomes an element itself
+        lp.clear();
+        in_pivot[p] = step;
+        for (size_t e : elems[p]) {
+            if (state[e] != Element) continue;
+            for (size_t v : vars[e])
+                if (weight[v] > 0 && in_pivot[v] != step) {
+                    in_pivot[v] = step;
+                    lp.push_back(v);
+                }
+            state[e] = Absorbed;
+            std::vector<size_t>().swap(vars[e]);
+        }
+        for (size_t v : vars[p])
+            if (state[v] == Variable && weight[v] > 0 && in_pivot[v] != step) {
+                in_pivot[v] = step;
+                lp.push_back(v);
+            }
+        state[p] = Element;
+        std::vector<size_t>().swap(elems[p]);
+        size_t lp_weight = 0;
+        for (size_t v : lp) {
+            remove(v);
+            lp_weight += weight[v];
+        }
+
+        // |Le \ Lp| for every element that shares a variable with Lp
+        for (size_t v : lp)
+            for (size_t e : elems[v]) {
+                if (state[e] != Element) continue;
+                if (external_step[e] != step) {
+                    external_step[e] = step;
+                    external[e] = esize[e];
+                }
+                external[e] -= weight[v];
+            }
+
+        // Prune each variable's lists and bound its degree by the sizes of what is left
+        for (size_t v : lp) {
+            size_t deg = 0, h = 0;
+            auto& ev = elems[v];
+            std::erase_if(ev, [&](size_t e) {
+                if (state[e] != Element) return true;
+                if (external[e] == 0) {  // Le is inside Lp: aggressive absorption
+                    state[e] = Absorbed;
+                    std::vector<size_t>().swap(vars[e]);
+                    return true;
+                }
+                deg += external[e];
+                h += e;
+                return false;
+            });
+            ev.push_back(p);
+            h += p;
+            h *= 0x9E3779B97F4A7C15ull;
+            std::erase_if(vars[v], [&](size_t u) {
+                if (state[u] != Variable || weight[u] == 0 || in_pivot[u] == step) return true;
+                deg += weight[u];
+                h += u;
+                return false;
+            });
+            partial[v] = deg;
+            hash[v] = h;
+        }
+
+        // Variables with the same element and variable lists are indistinguishable from now on
+        std::sort(lp.begin(), lp.end(), [&](size_t a, size_t b) { return hash[a] != hash[b] ? hash[a] < hash[b] : a < b; });
+        for (size_t a = 0; a < lp.size(); ++a) {
+            const size_t i = lp[a];
+            if (weight[i] == 0) continue;
+            bool sorted = false;
+            for (size_t b = a + 1; b < lp.size() && hash[lp[b]] == hash[i]; ++b) {
+                const size_t j = lp[b];
+                if (weight[j] == 0 || vars[i].size() != vars[j].size() || elems[i].size() != elems[j].size()) continue;
+                if (!sorted) {
+                    std::sort(vars[i].begin(), vars[i].end());
+                    std::sort(elems[i].begin(), elems[i].end());
+                    sorted = true;
+                }
+                std::sort(vars[j].begin(), vars[j].end());
+                std::sort(elems[j].begin(), elems[j].end());
+                if (vars[i] != vars[j] || elems[i] != elems[j]) continue;
+                weight[i] += weight[j];
+                weight[j] = 0;
+                state[j] = Absorbed;
+                members[i].push_back(j);
+                members[i].insert(members[i].end(), members[j].begin(), members[j].end());
+                std::vector<size_t>().swap(members[j]);
+                std::vector<size_t>().swap(vars[j]);
+                std::vector<size_t>().swap(elems[j]);
+            }
+        }
+
+        // d(v) <= min(variables left, old bound + |Lp \ v|, |A_v| + |Lp \ v| + sum |Le \ Lp|)
+        const size_t remaining = live - eliminated;
+        std::erase_if(lp, [&](size_t v) { return weight[v] == 0; });
+        for (size_t v : lp) {
+            const size_t others = lp_weight - weight[v];
+            degree[v] = std::min({remaining - weight[v], degree[v] + others, partial[v] + others});
+            min_degree = std::min(min_degree, degree[v]);
+            insert(v);
+        }
+        esize[p] = lp_weight;
+        vars[p] = lp;
+        if (lp.empty()) state[p] = Absorbed;
+    }
+
+    order.insert(order.end(), dense.begin(), dense.end());
+    return order;
+}
+
+} // namespace
+
+SparseLU::SparseLU(const SparseMatrix& A, Ordering ordering) {
+    analyze(A, ordering);
+    factorize(A);
+}
+
+void SparseLU::analyze(const SparseMatrix& A, Ordering ordering) {
+    if (A.rows() != A.cols())
+        throw std::invalid_argument("Matrix must be square");
+
+    m_n = A.rows();
+    m_row_offsets = A.row_offsets();
+    m_column_indices = A.column_indices();
+
+    if (ordering == Ordering::MinimumDegree) {
+        m_q = minimum_degree(m_n, m_row_offsets, m_column_indices);
+    } else {
+        m_q.resize(m_n);
+        std::iota(m_q.begin(), m_q.end(), size_t{0});
+    }
+
+    // Column-oriented view of the pattern; values are gathered through m_csr_to_csc
+    const size_t nnz = m_column_indices.size();
+    m_col_start.assign(m_n + 1, 0);
+    for (size_t c : m_column_indices) ++m_col_start[c + 1];
+    for (size_t c = 0; c < m_n; ++c) m_col_start[c + 1] += m_col_start[c];
+
+    std::vector<size_t> next(m_col_start.begin(), m_col_start.end() - 1);
+    m_col_rows.resize(nnz);
+    m_csr_to_csc.resize(nnz);
+    m_col_values.resize(nnz);
+    for (size_t r = 0; r < m_n; ++r)
+        for (size_t p = m_row_offsets[r]; p < m_row_offsets[r + 1]; ++p) {
+            const size_t dst = next[m_column_indices[p]]++;
+            m_col_rows[dst] = r;
+            m_csr_to_csc[p] = dst;
+        }
+
+    m_analyzed = true;
+    m_factorized = false;
+}
+
+void SparseLU::check_pattern(const SparseMatrix& A) const {
+    if (!m_analyzed)
+        throw std::logic_error("SparseLU::analyze must be called first");
+    if (A.rows() != m_n || A.cols() != m_n || A.row_offsets() != m_row_offsets ||
+        A.column_indices() != m_column_indices)
+        throw std::invalid_argument("Matrix sparsity pattern differs from the analyzed one");
+}
+
+void SparseLU::gather_columns(const SparseMatrix& A) {
+    const auto& values = A.values();
+    for (size_t p = 0; p < values.size(); ++p)
+        m_col_values[m_csr_to_csc[p]] = values[p];
+}
+
+void SparseLU::factorize(const SparseMatrix& A) {
+    check_pattern(A);
+    gather_columns(A);
+
+    const size_t n = m_n;
+    m_pivot_row.assign(n, NONE);
+    m_L_start.assign(1, 0);
+    m_U_start.assign(1, 0);
+    m_L_rows.clear();
+    m_L_values.clear();
+    m_U_rows.clear();
+    m_U_values.clear();
+    m_U_diag.assign(n, 0.0);
+
+    std::vector<size_t> pinv(n, NONE);      // row -> pivot step
+    std::vector<double> x(n, 0.0);          // dense accumulator for the current column
+    std::vector<size_t> mark(n, NONE);      // DFS visit stamp (column index)
+    std::vector<size_t> reach(n);           // topological order fills reach[top..n)
+    std::vector<std::pair<size_t, size_t>> stack;
+
+    for (size_t k = 0; k < n; ++k) {
+        const size_t j = m_q[k];
+
+        // Nonzero pattern of L \ A(:, j): reverse postorder of a DFS through the columns of L
+        size_t top = n;
+        for (size_t p = m_col_start[j]; p < m_col_start[j + 1]; ++p) {
+            const size_t start = m_col_rows[p];
+            if (mark[start] == k) continue;
+            mark[start] = k;
+            stack.emplace_back(start, 0);
+            while (!stack.empty()) {
+                auto& [node, child] = stack.back();
+                const size_t col = pinv[node];
+                bool descended = false;
+                if (col != NONE) {
+                    for (size_t end = m_L_start[col + 1]; m_L_start[col] + child < end;) {
+                        const size_t next_row = m_L_rows[m_L_start[col] + child++];
+                        if (mark[next_row] != k) {
+                            mark[next_row] = k;
+                            stack.emplace_back(next_row, 0);
+                            descended = true;
+                            break;
+                        }
+                    }
+                }
+                if (!descended) {
+                    reach[--top] = node;
+                    stack.pop_back();
+                }
+            }
+        }
+
+        // Sparse triangular solve L x = A(:, j)
+        for (size_t p = m_col_start[j]; p < m_col_start[j + 1]; ++p)
+            x[m_col_rows[p]] = m_col_values[p];
+        for (size_t t = top; t < n; ++t) {
+            const size_t row = reach[t];
+            const size_t col = pinv[row];
+            if (col == NONE) continue;
+            const double v = x[row];
+            for (size_t p = m_L_start[col]; p < m_L_start[col + 1]; ++p)
+                x[m_L_rows[p]] -= m_L_values[p] * v;
+        }
+
+        // Threshold partial pivoting, keeping the diagonal when it is large enough so the
+        // fill-reducing ordering stays effective
+        size_t piv = NONE;
+        double largest = 0.0;
+        for (size_t t = top; t < n; ++t) {
+            const size_t row = reach[t];
+            if (pinv[row] == NONE && std::abs(x[row]) > largest) {
+                largest = std::abs(x[row]);
+                piv = row;
+            }
+        }
+        if (piv == NONE || largest == 0.0)
+            throw std::runtime_error("Singular matrix");
+        if (pinv[j] == NONE && mark[j] == k && std::abs(x[j]) >= pivot_tolerance * largest)
+            piv = j;
+
+        const double pivot = x[piv];
+        pinv[piv] = k;
+        m_pivot_row[k] = piv;
+        m_U_diag[k] = pivot;
+
+        for (size_t t = top; t < n; ++t) {
+            const size_t row = reach[t];
+            if (row == piv) {
+            } else if (pinv[row] != NONE) {
+                m_U_rows.push_back(pinv[row]);
+                m_U_values.push_back(x[row]);
+            } else {
+                m_L_rows.push_back(row);
+                m_L_values.push_back(x[row] / pivot);
+            }
+            x[row] = 0.0;
+        }
+        m_L_start.push_back(m_L_rows.size());
+        m_U_start.push_back(m_U_rows.size());
+    }
+
+    m_factorized = true;
+}
+
+void SparseLU::refactorize(const SparseMatrix& A) {
+    if (!m_factorized)
+        throw std::logic_error("SparseLU::factorize must be called before refactorize");
+    check_pattern(A);
+    gather_columns(A);
+
+    std::vector<double> x(m_n, 0.0);
+    for (size_t k = 0; k < m_n; ++k) {
+        const size_t j = m_q[k];
+        for (size_t p = m_col_start[j]; p < m_col_start[j + 1]; ++p)
+            x[m_col_rows[p]] = m_col_values[p];
+
+        // U entries are stored in topological order, so the solve replays without a DFS
+        for (size_t p = m_U_start[k]; p < m_U_start[k + 1]; ++p) {
+            const size_t col = m_U_rows[p];
+            const size_t row = m_pivot_row[col];
+            const double v = x[row];
+            m_U_values[p] = v;
+            x[row] = 0.0;
+            for (size_t q = m_L_start[col]; q < m_L_start[col + 1]; ++q)
+                x[m_L_rows[q]] -= m_L_values[q] * v;
+        }
+
+        const size_t piv = m_pivot_row[k];
+        const double pivot = x[piv];
+        x[piv] = 0.0;
+        double largest = std::abs(pivot);
+        for (size_t p = m_L_start[k]; p < m_L_start[k + 1]; ++p)
+            largest = std::max(largest, std::abs(x[m_L_rows[p]]));
+        if (pivot == 0.0 || std::abs(pivot) < pivot_tolerance * largest) {
+            m_factorized = false;
+            throw std::runtime_error("Pivot too small for refactorization; call factorize");
+        }
+
+        m_U_diag[k] = pivot;
+        for (size_t p = m_L_start[k]; p < m_L_start[k + 1]; ++p) {
+            const size_t row = m_L_rows[p];
+            m_L_values[p] = x[row] / pivot;
+            x[row] = 0.0;
+        }
+    }
+}
+
+void SparseLU::solve(std::span<const double> b, std::span<double> x) const {
+    if (!m_factorized)
+        throw std::logic_error("SparseLU::factorize must be called first");
+    if (b.size() != m_n || x.size() != m_n)
+        throw std::invalid_argument("Matrix and vector dimension mismatch");
+
+    // L z = P b, in original row space
+    std::vector<double> w(b.begin(), b.end());
+    std::vector<double> z(m_n);
+    for (size_t k = 0; k < m_n; ++k) {
+        const double v = w[m_pivot_row[k]];
+        z[k] = v;
+        if (v == 0.0) continue;
+        for (size_t p = m_L_start[k]; p < m_L_start[k + 1]; ++p)
+            w[m_L_rows[p]] -= m_L_values[p] * v;
+    }
+
+    // U y = z, column oriented; x = Q y
+    for (size_t k = m_n; k-- > 0;) {
+        const double v = z[k] / m_U_diag[k];
+        x[m_q[k]] = v;
+        if (v == 0.0) continue;
+        for (size_t p = m_U_start[k]; p < m_U_start[k + 1]; ++p)
+            z[m_U_rows[p]] -= m_U_values[p] * v;
+    }
+}
+
+std::vector<double> SparseLU::solve(const std::vector<double>& b) const {
+    std::vector<double> x(b.size());
+    solve(b, x);
+    return x;
+}
+
+size_t SparseLU::size() const { return m_n; }
+const std::vector<size_t>& SparseLU::column_permutation() const { return m_q; }
+size_t SparseLU::nonzeros_L() const { return m_L_rows.size(); }
+size_t SparseLU::nonzeros_U() const { return m_U_rows.size() + m_U_diag.size(); }
+
+} // namespace imeth
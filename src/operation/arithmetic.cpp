@@ -1,5 +1,13 @@
 #include "../include/imeth/operation/arithmetic.hpp"
+#include "../include/imeth/operation/number_theory.hpp"
+#include "../detail/reduce.hpp"
+#include "../detail/selection.hpp"
+#include "../detail/vector_math.hpp"
+#include "../detail/wide.hpp"
 #include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <limits>
 #include <stdexcept>
 
 namespace imeth::Arithmetic {
@@ -25,39 +33,74 @@ double divide(double a, double b) {
 }
 
 // Power and Roots
+namespace {
+
+// Each squaring doubles the relative error, so repeated squaring is about 0.8 * |exponent| ulp
+// off. Past this (the same limit Expression uses) std::pow is both fixed-cost and within an ulp.
+constexpr int POWI_MAX_EXPONENT = 64;
+
+bool squares_accurately(const int exponent) {
+    return exponent >= -POWI_MAX_EXPONENT && exponent <= POWI_MAX_EXPONENT;
+}
+
+} // namespace
+
 double power(double base, int exponent) {
-    double result = 1.0;
-    for (int i = 0; i < exponent; i++) {
-        result *= base;
+    if (!squares_accurately(exponent)) {
+        return std::pow(base, exponent);
     }
-    return result;
+    return detail::vmath::powi(base, exponent);
 }
 
 double square_root(double n) {
     if (n < 0) {
         throw std::invalid_argument("Cannot take square root of negative number");
     }
-    auto z = n;
-    for (int i = 0; i < 10; i++) { z = (z + n / z) / 2.0; }
-    return z;
+    return std::sqrt(n);
 }
 
 double cube_root(double n) {
-    if (n == 0) return 0;
-    bool negative = n < 0;
-    if (negative) n = -n;
+    return detail::vmath::cbrt(n);
+}
 
-    double x = n;
-    double epsilon = 1e-10;
+namespace {
 
-    while (true) {
-        double x_next = (2.0 * x + n / (x * x)) / 3.0;
-        if (absolute(x_next - x) < epsilon) break;
+void require_same_size(size_t in, size_t out) {
+    if (in != out) {
+        throw std::invalid_argument("Input and output sizes differ");
+    }
+}
+
+} // namespace
 
-        x = x_next;
+void power(std::span<const double> bases, int exponent, std::span<double> out) {
+    require_same_size(bases.size(), out.size());
+    detail::reduce::for_each_block(bases.size(), [&](size_t, size_t lo, size_t hi) {
+        if (squares_accurately(exponent)) {
+            detail::vmath::powi(bases.data() + lo, exponent, out.data() + lo, hi - lo);
+        } else {
+            for (size_t i = lo; i < hi; ++i) out[i] = std::pow(bases[i], exponent);
+        }
+    });
+}
+
+void square_root(std::span<const double> numbers, std::span<double> out) {
+    require_same_size(numbers.size(), out.size());
+    std::atomic<bool> negative{false};
+    detail::reduce::for_each_block(numbers.size(), [&](size_t, size_t lo, size_t hi) {
+        if (detail::vmath::sqrt(numbers.data() + lo, out.data() + lo, hi - lo))
+            negative.store(true, std::memory_order_relaxed);
+    });
+    if (negative.load()) {
+        throw std::invalid_argument("Cannot take square root of negative number");
     }
+}
 
-    return negative ? -x : x;
+void cube_root(std::span<const double> numbers, std::span<double> out) {
+    require_same_size(numbers.size(), out.size());
+    detail::reduce::for_each_block(numbers.size(), [&](size_t, size_t lo, size_t hi) {
+        detail::vmath::cbrt(numbers.data() + lo, out.data() + lo, hi - lo);
+    });
 }
 
 // Absolute Value and Sign
@@ -116,53 +159,121 @@ double percent_decrease(double original, double newValue) {
 
 // Averages and Statistics
 double average(const std::vector<double>& numbers) {
+    return average(std::span<const double>(numbers));
+}
+
+double sum(const std::vector<double>& numbers) {
+    return sum(std::span<const double>(numbers));
+}
+
+double minimum(const std::vector<double>& numbers) {
+    return minimum(std::span<const double>(numbers));
+}
+
+double maximum(const std::vector<double>& numbers) {
+    return maximum(std::span<const double>(numbers));
+}
+
+double range(const std::vector<double>& numbers) {
+    return range(std::span<const double>(numbers));
+}
+
+double median(std::vector<double> numbers) {
+    return median_in_place(numbers);
+}
+
+double median_in_place(std::span<double> numbers) {
+    if (numbers.empty()) {
+        throw std::invalid_argument("Cannot find median of empty list");
+    }
+
+    // Introselect instead of a full sort; for an even size the lower middle value is the
+    // largest element left of the upper one
+    const size_t half = numbers.size() / 2;
+    std::nth_element(numbers.begin(), numbers.begin() + half, numbers.end());
+    if (numbers.size() % 2 != 0) {
+        return numbers[half];
+    }
+    const double lower = *std::max_element(numbers.begin(), numbers.begin() + half);
+    return (lower + numbers[half]) / 2.0;
+}
+
+double quantile(std::span<const double> numbers, double p) {
+    return detail::quantiles(numbers.data(), numbers.size(), {p}).front();
+}
+
+std::vector<double> quantiles(std::span<const double> numbers, const std::vector<double>& probabilities) {
+    return detail::quantiles(numbers.data(), numbers.size(), probabilities);
+}
+
+std::vector<double> quantiles_in_place(std::span<double> numbers, const std::vector<double>& probabilities) {
+    return detail::quantiles_in_place(numbers.data(), numbers.size(), probabilities);
+}
+
+double sum(std::span<const double> numbers, Summation method) {
+    return detail::reduce::sum(numbers.data(), numbers.size(), detail::reduce::method_of(method));
+}
+
+double sum(std::span<const float> numbers, Summation method) {
+    return detail::reduce::sum(numbers.data(), numbers.size(), detail::reduce::method_of(method));
+}
+
+double average(std::span<const double> numbers, Summation method) {
     if (numbers.empty()) {
         throw std::invalid_argument("Cannot find average of empty list");
     }
-    return sum(numbers) / numbers.size();
+    return sum(numbers, method) / static_cast<double>(numbers.size());
 }
 
-double sum(const std::vector<double>& numbers) {
-    double total = 0;
-    for (const double n : numbers) {
-        total += n;
+double average(std::span<const float> numbers, Summation method) {
+    if (numbers.empty()) {
+        throw std::invalid_argument("Cannot find average of empty list");
     }
-    return total;
+    return sum(numbers, method) / static_cast<double>(numbers.size());
 }
 
-double minimum(const std::vector<double>& numbers) {
+double minimum(std::span<const double> numbers) {
     if (numbers.empty()) {
         throw std::invalid_argument("Cannot find minimum of empty list");
     }
-    return *std::ranges::min_element(numbers);
+    return detail::reduce::min(numbers.data(), numbers.size());
 }
 
-double maximum(const std::vector<double>& numbers) {
+float minimum(std::span<const float> numbers) {
     if (numbers.empty()) {
-        throw std::invalid_argument("Cannot find maximum of empty list");
+        throw std::invalid_argument("Cannot find minimum of empty list");
     }
-    return *std::ranges::max_element(numbers);
+    return detail::reduce::min(numbers.data(), numbers.size());
 }
 
-double range(const std::vector<double>& numbers) {
-    return maximum(numbers) - minimum(numbers);
+double maximum(std::span<const double> numbers) {
+    if (numbers.empty()) {
+        throw std::invalid_argument("Cannot find maximum of empty list");
+    }
+    return detail::reduce::max(numbers.data(), numbers.size());
 }
 
-double median(std::vector<double> numbers) {
+float maximum(std::span<const float> numbers) {
     if (numbers.empty()) {
-        throw std::invalid_argument("Cannot find median of empty list");
+        throw std::invalid_argument("Cannot find maximum of empty list");
     }
+    return detail::reduce::max(numbers.data(), numbers.size());
+}
 
-    std::sort(numbers.begin(), numbers.end());
-    int size = numbers.size();
+double range(std::span<const double> numbers) {
+    if (numbers.empty()) {
+        throw std::invalid_argument("Cannot find range of empty list");
+    }
+    const auto [lo, hi] = detail::reduce::minmax(numbers.data(), numbers.size());
+    return hi - lo;
+}
 
-    if (size % 2 == 0) {
-        // Even number of elements: average of two middle values
-        return (numbers[size / 2 - 1] + numbers[size / 2]) / 2.0;
-    } else {
-        // Odd number of elements: middle value
-        return numbers[size / 2];
+float range(std::span<const float> numbers) {
+    if (numbers.empty()) {
+        throw std::invalid_argument("Cannot find range of empty list");
     }
+    const auto [lo, hi] = detail::reduce::minmax(numbers.data(), numbers.size());
+    return hi - lo;
 }
 
 // Fractions
@@ -242,32 +353,30 @@ bool isOdd(const int n) {
 }
 
 bool is_prime(const int n) {
-    if (n <= 1) return false;
-    if (n == 2) return true;
-    if (n % 2 == 0) return false;
+    return n > 1 && NumberTheory::is_prime(static_cast<std::uint64_t>(n));
+}
+
+namespace {
 
-    // Check odd divisors up to square root
-    for (int i = 3; i * i <= n; i += 2) {
-        if (n % i == 0) return false;
+std::uint64_t magnitude(const int n) {
+    return n < 0 ? 0 - static_cast<std::uint64_t>(n) : static_cast<std::uint64_t>(n);
+}
+
+int to_int(const std::uint64_t n, const char* what) {
+    if (n > static_cast<std::uint64_t>(std::numeric_limits<int>::max())) {
+        throw std::overflow_error(what);
     }
-    return true;
+    return static_cast<int>(n);
 }
 
-int greatest_common_divisor(int a, int b) {
-    a = absolute(a);
-    b = absolute(b);
+} // namespace
 
-    while (b != 0) {
-        const int temp = b;
-        b = a % b;
-        a = temp;
-    }
-    return a;
+int greatest_common_divisor(const int a, const int b) {
+    return to_int(NumberTheory::gcd(magnitude(a), magnitude(b)), "Greatest common divisor does not fit in int");
 }
 
 int least_common_multiple(const int a, const int b) {
-    if (a == 0 || b == 0) return 0;
-    return absolute(a * b) / greatest_common_divisor(a, b);
+    return to_int(NumberTheory::lcm(magnitude(a), magnitude(b)), "Least common multiple does not fit in int");
 }
 
 // Distance and Pythagorean
@@ -287,20 +396,98 @@ double simple_interest(const double principal, const double rate, const double t
 }
 
 // Sequnces
-void sequence(const uint_t first, const uint_t diff, unsigned int terms, std::vector<uint_t>& result) {
-    result.clear();
-    result.reserve(terms);
-    for (unsigned int i = 0; i < terms; ++i) {
-        result.push_back(first + i * diff);
+namespace {
+
+constexpr uint_t UINT_T_MAX = std::numeric_limits<uint_t>::max();
+
+// Result of an operation whose exact value did not fit; `wrapped` is that value modulo 2^64
+uint_t overflowed(const Overflow overflow, const uint_t wrapped, const char* what) {
+    switch (overflow) {
+    case Overflow::Throw: throw std::overflow_error(what);
+    case Overflow::Saturate: return UINT_T_MAX;
+    case Overflow::Wrap: break;
+    }
+    return wrapped;
+}
+
+void check_term_index(const unsigned int n) {
+    if (n == 0) {
+        throw std::invalid_argument("Sequence terms are numbered from 1");
+    }
+}
+
+void check_modulus(const uint_t modulus) {
+    if (modulus == 0) {
+        throw std::invalid_argument("Modulus must be positive");
     }
 }
 
-uint_t sequence_sum(const uint_t first, const uint_t last, const unsigned int terms) {
-    return terms * (first + last) / 2;
+// first + index * diff, exactly
+detail::wide::U128 exact_term(const uint_t first, const uint_t diff, const uint_t index) {
+    detail::wide::U128 t = detail::wide::mul(index, diff);
+    t.hi += detail::wide::add_overflow(t.lo, first, t.lo);
+    return t;
+}
+
+// terms * (first + last) / 2, exactly: a 65-bit pair times a 32-bit count fits in 97 bits
+detail::wide::U128 exact_sum(const uint_t first, const uint_t last, const unsigned int terms) {
+    std::uint64_t pair;
+    const bool carry = detail::wide::add_overflow(first, last, pair);
+    detail::wide::U128 s = detail::wide::mul(terms, pair);
+    if (carry) s.hi += terms;
+    return {s.hi >> 1, (s.lo >> 1) | (s.hi << 63)};
+}
+
+} // namespace
+
+void sequence(const uint_t first, const uint_t diff, unsigned int terms, std::vector<uint_t>& result,
+              const Overflow overflow) {
+    // Terms never decrease, so only the last one can overflow first
+    std::uint64_t last = 0;
+    const bool fits = terms == 0 || !(detail::wide::mul_overflow(terms - 1, diff, last) ||
+                                      detail::wide::add_overflow(first, last, last));
+    if (fits || overflow == Overflow::Wrap) {
+        result.resize(terms);
+        ArithmeticSequence(first, diff, terms).fill(0, result);
+        return;
+    }
+    if (overflow == Overflow::Throw) {
+        throw std::overflow_error("Sequence terms do not fit in 64 bits");
+    }
+    // Saturate: terms up to index (max - first) / diff fit, the rest are clamped
+    const uint_t fitting = (UINT_T_MAX - first) / diff + 1;
+    result.assign(terms, UINT_T_MAX);
+    ArithmeticSequence(first, diff, fitting).fill(0, std::span(result).first(fitting));
+}
+
+ArithmeticSequence sequence(const uint_t first, const uint_t diff, const uint_t terms) {
+    return {first, diff, terms};
+}
+
+uint_t sequence_sum(const uint_t first, const uint_t last, const unsigned int terms, const Overflow overflow) {
+    const detail::wide::U128 s = exact_sum(first, last, terms);
+    if (s.hi != 0) [[unlikely]] return overflowed(overflow, s.lo, "Sequence sum does not fit in 64 bits");
+    return s.lo;
+}
+
+uint_t nth_term(const uint_t first, const uint_t diff, const unsigned int n, const Overflow overflow) {
+    check_term_index(n);
+    std::uint64_t term;
+    // Each check is a jump on the flag the multiply or add already set
+    if (detail::wide::mul_overflow(n - 1, diff, term) || detail::wide::add_overflow(first, term, term)) [[unlikely]]
+        return overflowed(overflow, first + (n - 1) * diff, "Sequence term does not fit in 64 bits");
+    return term;
+}
+
+uint_t sequence_sum_mod(const uint_t first, const uint_t last, const unsigned int terms, const uint_t modulus) {
+    check_modulus(modulus);
+    return detail::wide::mod(exact_sum(first, last, terms), modulus);
 }
 
-uint_t nth_term(const uint_t first, const uint_t diff, const unsigned int n) {
-    return first + (n - 1) * diff;
+uint_t nth_term_mod(const uint_t first, const uint_t diff, const unsigned int n, const uint_t modulus) {
+    check_term_index(n);
+    check_modulus(modulus);
+    return detail::wide::mod(exact_term(first, diff, n - 1), modulus);
 }
 
 } // namespace imeth
@@ -1,5 +1,7 @@
 #include "../include/imeth/operation/combinatoric.hpp"
 #include "../include/imeth/operation/arithmetic.hpp"
+#include "../detail/reduce.hpp"
+#include <cmath>
 #include <algorithm>
 #include <numeric>
 #include <iterator>
@@ -498,27 +500,43 @@ namespace imeth::Combinatorics {
                 return (p_b_given_a * p_a) / p_b;
             }
 
-            double expected_value(const std::vector<double>& values, const std::vector<double>& probabilities) {
-                double result = 0.0;
-                size_t size = std::min(values.size(), probabilities.size());
-                for (size_t i = 0; i < size; ++i) {
-                    result += values[i] * probabilities[i];
-                }
-                return result;
-            }
-
-            double variance(const std::vector<double>& values, const std::vector<double>& probabilities) {
-                double ev = expected_value(values, probabilities);
-                double result = 0.0;
-                size_t size = std::min(values.size(), probabilities.size());
-                for (size_t i = 0; i < size; ++i) {
-                    result += probabilities[i] * Arithmetic::power(values[i] - ev, 2);
-                }
-                return result;
+            double expected_value(const std::vector<double>& values, const std::vector<double>& probabilities,
+                                  const Arithmetic::Summation method) {
+                const size_t size = std::min(values.size(), probabilities.size());
+                const double* x = values.data();
+                const double* p = probabilities.data();
+                return detail::reduce::sum_terms(size, detail::reduce::method_of(method),
+                    [&](size_t lo, size_t hi, double* terms, double* errors) {
+                        for (size_t i = lo; i < hi; ++i) terms[i - lo] = x[i] * p[i];
+                        if (errors)
+                            for (size_t i = lo; i < hi; ++i) errors[i - lo] = std::fma(x[i], p[i], -terms[i - lo]);
+                    });
+            }
+
+            double variance(const std::vector<double>& values, const std::vector<double>& probabilities,
+                            const Arithmetic::Summation method) {
+                const double ev = expected_value(values, probabilities, method);
+                const size_t size = std::min(values.size(), probabilities.size());
+                const double* x = values.data();
+                const double* p = probabilities.data();
+                return detail::reduce::sum_terms(size, detail::reduce::method_of(method),
+                    [&](size_t lo, size_t hi, double* terms, double* errors) {
+                        for (size_t i = lo; i < hi; ++i) {
+                            const double d = x[i] - ev;
+                            terms[i - lo] = p[i] * (d * d);
+                        }
+                        if (errors)
+                            for (size_t i = lo; i < hi; ++i) {
+                                const double d = x[i] - ev;
+                                const double sq = d * d;
+                                errors[i - lo] = std::fma(p[i], sq, -terms[i - lo]) + p[i] * std::fma(d, d, -sq);
+                            }
+                    });
             }
 
-            double standard_deviation(const std::vector<double>& values, const std::vector<double>& probabilities) {
-                return Arithmetic::square_root(variance(values, probabilities));
+            double standard_deviation(const std::vector<double>& values, const std::vector<double>& probabilities,
+                                      const Arithmetic::Summation method) {
+                return Arithmetic::square_root(variance(values, probabilities, method));
             }
         }
     }
@@ -823,13 +841,12 @@ namespace imeth::Combinatorics {
     namespace Sequences {
         void geometric_sequence(uint_t first, uint_t ratio, unsigned int terms,
                                 std::vector<uint_t>& result) {
-            result.clear();
-            result.reserve(terms);
-            uint_t current = first;
-            for (unsigned int i = 0; i < terms; ++i) {
-                result.push_back(current);
-                current *= ratio;
-            }
+            result.resize(terms);
+            GeometricSequence(first, ratio, terms).fill(0, result);
+        }
+
+        GeometricSequence geometric_sequence(uint_t first, uint_t ratio, uint_t terms) {
+            return {first, ratio, terms};
         }
 
         uint_t geometric_sum(uint_t first, uint_t ratio, unsigned int terms) {
@@ -842,11 +859,7 @@ namespace imeth::Combinatorics {
         }
 
         uint_t nth_term_geometric(uint_t first, uint_t ratio, unsigned int n) {
-            uint_t result = first;
-            for (unsigned int i = 1; i < n; ++i) {
-                result *= ratio;
-            }
-            return result;
+            return GeometricSequence(first, ratio, n).term(n == 0 ? 0 : n - 1);
         }
     }
 
@@ -0,0 +1,456 @@
+#include "../include/imeth/operation/expression.hpp"
+#include "../detail/parallel.hpp"
+#include "../detail/vector_math.hpp"
+#include <algorithm>
+#include <array>
+#include <cctype>
+#include <charconv>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <numbers>
+#include <stdexcept>
+
+namespace imeth {
+
+namespace {
+
+// Rows per block of batched evaluation; one register holds one block
+constexpr size_t BATCH = 256;
+// Instructions times rows below which a batch is evaluated on the calling thread
+constexpr size_t PARALLEL_WORK = size_t{1} << 18;
+// Registers kept on the stack by single-row evaluation
+constexpr size_t STACK_REGISTERS = 16;
+// Largest |n| for which x ^ n becomes binary exponentiation
+constexpr double MAX_INTEGER_EXPONENT = 64;
+
+bool is_name_start(const char c) { return std::isalpha(static_cast<unsigned char>(c)) || c == '_'; }
+bool is_name_char(const char c) { return std::isalnum(static_cast<unsigned char>(c)) || c == '_'; }
+
+[[noreturn]] void syntax_error(const std::string& what, const size_t position) {
+    throw std::invalid_argument(what + " at position " + std::to_string(position + 1));
+}
+
+} // namespace
+
+// Recursive descent parser that folds while it builds the tree, then emits bytecode from the
+// root with registers released as soon as their value has been consumed
+class Expression::Compiler {
+public:
+    Compiler(Expression& program, std::string_view formula) : m_program(program), m_text(formula) {}
+
+    void compile() {
+        const int root = parse_sum();
+        skip_space();
+        if (m_pos < m_text.size()) syntax_error(std::string("Unexpected '") + m_text[m_pos] + "'", m_pos);
+        m_program.m_result = emit(root);
+    }
+
+private:
+    enum class Kind : std::uint8_t { Constant, Variable, Operation };
+
+    struct Node {
+        Kind kind;
+        Op op;
+        double value;     // Constant
+        std::uint32_t variable;
+        int a, b;         // children of an Operation, -1 if absent
+        int exponent;     // PowerInt
+    };
+
+    struct Function {
+        std::string_view name;
+        Op op;
+        int arguments;
+    };
+
+    static constexpr std::array<Function, 21> FUNCTIONS{{
+        {"sqrt", Op::Sqrt, 1},   {"cbrt", Op::Cbrt, 1},   {"abs", Op::Abs, 1},
+        {"exp", Op::Exp, 1},     {"ln", Op::Ln, 1},       {"log10", Op::Log10, 1},
+        {"log2", Op::Log2, 1},   {"sin", Op::Sin, 1},     {"cos", Op::Cos, 1},
+        {"tan", Op::Tan, 1},     {"asin", Op::Asin, 1},   {"acos", Op::Acos, 1},
+        {"atan", Op::Atan, 1},   {"floor", Op::Floor, 1}, {"ceil", Op::Ceil, 1},
+        {"round", Op::Round, 1}, {"min", Op::Min, 2},     {"max", Op::Max, 2},
+        {"pow", Op::Power, 2},   {"atan2", Op::Atan2, 2}, {"hypot", Op::Hypot, 2},
+    }};
+
+    // Tree building, folding as it goes
+
+    int add_node(const Node& node) {
+        m_nodes.push_back(node);
+        return static_cast<int>(m_nodes.size() - 1);
+    }
+
+    int constant(const double value) { return add_node({Kind::Constant, Op::Add, value, 0, -1, -1, 0}); }
+
+    bool is_constant(const int node) const { return m_nodes[node].kind == Kind::Constant; }
+    bool is_constant(const int node, const double value) const {
+        return is_constant(node) && m_nodes[node].value == value && !std::signbit(m_nodes[node].value);
+    }
+
+    int unary(const Op op, const int x) {
+        if (is_constant(x)) return constant(apply(op, m_nodes[x].value, 0.0, 0));
+        if (op == Op::Negate && m_nodes[x].kind == Kind::Operation && m_nodes[x].op == Op::Negate)
+            return m_nodes[x].a;
+        return add_node({Kind::Operation, op, 0.0, 0, x, -1, 0});
+    }
+
+    int binary(const Op op, const int x, const int y) {
+        if (is_constant(x) && is_constant(y)) return constant(apply(op, m_nodes[x].value, m_nodes[y].value, 0));
+        switch (op) {
+        case Op::Multiply:
+            if (is_constant(y, 1.0)) return x;
+            if (is_constant(x, 1.0)) return y;
+            break;
+        case Op::Divide:
+            if (is_constant(y, 1.0)) return x;
+            break;
+        case Op::Subtract:
+            if (is_constant(y, 0.0)) return x;  // only +0: x - (-0) turns -0 into +0
+            break;
+        case Op::Power:
+            if (is_constant(y)) {
+                const double n = m_nodes[y].value;
+                if (n == 1.0) return x;
+                if (n == std::trunc(n) && std::fabs(n) <= MAX_INTEGER_EXPONENT)
+                    return add_node({Kind::Operation, Op::PowerInt, 0.0, 0, x, -1, static_cast<int>(n)});
+            }
+            break;
+        default:
+            break;
+        }
+        return add_node({Kind::Operation, op, 0.0, 0, x, y, 0});
+    }
+
+    // Parsing
+
+    void skip_space() {
+        while (m_pos < m_text.size() && std::isspace(static_cast<unsigned char>(m_text[m_pos]))) ++m_pos;
+    }
+
+    bool accept(const char c) {
+        skip_space();
+        if (m_pos < m_text.size() && m_text[m_pos] == c) {
+            ++m_pos;
+            return true;
+        }
+        return false;
+    }
+
+    void expect(const char c) {
+        if (!accept(c)) {
+            if (m_pos == m_text.size()) syntax_error(std::string("Expected '") + c + "' but the formula ended", m_pos);
+            syntax_error(std::string("Expected '") + c + "'", m_pos);
+        }
+    }
+
+    // sum := product (('+' | '-') product)*
+    int parse_sum() {
+        int left = parse_product();
+        while (true) {
+            if (accept('+'))
+                left = binary(Op::Add, left, parse_product());
+            else if (accept('-'))
+                left = binary(Op::Subtract, left, parse_product());
+            else
+                return left;
+        }
+    }
+
+    // product := sign (('*' | '/' | '%') sign)*
+    int parse_product() {
+        int left = parse_sign();
+        while (true) {
+            if (accept('*'))
+                left = binary(Op::Multiply, left, parse_sign());
+            else if (accept('/'))
+                left = binary(Op::Divide, left, parse_sign());
+            else if (accept('%'))
+                left = binary(Op::Modulo, left, parse_sign());
+            else
+                return left;
+        }
+    }
+
+    // sign := ('-' | '+') sign | power
+    int parse_sign() {
+        if (accept('-')) return unary(Op::Negate, parse_sign());
+        if (accept('+')) return parse_sign();
+        return parse_power();
+    }
+
+    // power := primary ('^' sign)?   the exponent may carry its own sign: 2 ^ -1
+    int parse_power() {
+        const int base = parse_primary();
+        if (accept('^')) return binary(Op::Power, base, parse_sign());
+        return base;
+    }
+
+    // primary := number | name | name '(' arguments ')' | '(' sum ')'
+    int parse_primary() {
+        skip_space();
+        if (m_pos == m_text.size()) syntax_error("Unexpected end of formula", m_pos);
+        const char c = m_text[m_pos];
+        if (c == '(') {
+            ++m_pos;
+            const int inner = parse_sum();
+            expect(')');
+            return inner;
+        }
+        if (std::isdigit(static_cast<unsigned char>(c)) || c == '.') return parse_number();
+        if (is_name_start(c)) return parse_name();
+        syntax_error(std::string("Unexpected '") + c + "'", m_pos);
+    }
+
+    int parse_number() {
+        double value;
+        const char* first = m_text.data() + m_pos;
+        const auto [end, error] = std::from_chars(first, m_text.data() + m_text.size(), value);
+        if (error == std::errc::invalid_argument) syntax_error("Malformed number", m_pos);
+        // Out-of-range literals saturate like the rest of the arithmetic
+        if (error == std::errc::result_out_of_range) value = std::strtod(std::string(first, end).c_str(), nullptr);
+        m_pos += static_cast<size_t>(end - first);
+        return constant(value);
+    }
+
+    int parse_name() {
+        const size_t start = m_pos;
+        while (m_pos < m_text.size() && is_name_char(m_text[m_pos])) ++m_pos;
+        const std::string_view name = m_text.substr(start, m_pos - start);
+
+        if (accept('(')) {
+            const auto function = std::find_if(FUNCTIONS.begin(), FUNCTIONS.end(),
+                                               [&](const Function& f) { return f.name == name; });
+            if (function == FUNCTIONS.end()) syntax_error("Unknown function '" + std::string(name) + "'", start);
+            const int x = parse_sum();
+            if (function->arguments == 1) {
+                expect(')');
+                return unary(function->op, x);
+            }
+            if (!accept(',')) syntax_error("Function '" + std::string(name) + "' takes 2 arguments", start);
+            const int y = parse_sum();
+            expect(')');
+            return binary(function->op, x, y);
+        }
+
+        const auto& variables = m_program.m_variables;
+        const auto variable = std::find(variables.begin(), variables.end(), name);
+        if (variable != variables.end()) {
+            const auto index = static_cast<std::uint32_t>(variable - variables.begin());
+            return add_node({Kind::Variable, Op::Add, 0.0, index, -1, -1, 0});
+        }
+        if (name == "pi") return constant(std::numbers::pi);
+        if (name == "e") return constant(std::numbers::e);
+        syntax_error("Unknown name '" + std::string(name) + "'", start);
+    }
+
+    // Code generation
+
+    Operand emit(const int index) {
+        const Node node = m_nodes[index];
+        if (node.kind == Kind::Variable) return {Operand::Source::Variable, node.variable};
+        if (node.kind == Kind::Constant) return intern(node.value);
+
+        const Operand a = emit(node.a);
+        const Operand b = node.b >= 0 ? emit(node.b) : a;
+        release(a);
+        release(b);
+        const std::uint32_t target = acquire();
+        m_program.m_code.push_back({node.op, target, a, b, node.exponent});
+        return {Operand::Source::Register, target};
+    }
+
+    // Constants are compared bit for bit, so 0 and -0 stay apart
+    Operand intern(const double value) {
+        auto& constants = m_program.m_constants;
+        for (size_t i = 0; i < constants.size(); ++i)
+            if (std::memcmp(&constants[i], &value, sizeof value) == 0)
+                return {Operand::Source::Constant, static_cast<std::uint32_t>(i)};
+        constants.push_back(value);
+        return {Operand::Source::Constant, static_cast<std::uint32_t>(constants.size() - 1)};
+    }
+
+    std::uint32_t acquire() {
+        const auto free = std::find(m_busy.begin(), m_busy.end(), false);
+        if (free != m_busy.end()) {
+            *free = true;
+            return static_cast<std::uint32_t>(free - m_busy.begin());
+        }
+        m_busy.push_back(true);
+        m_program.m_registers = static_cast<std::uint32_t>(m_busy.size());
+        return m_program.m_registers - 1;
+    }
+
+    void release(const Operand operand) {
+        if (operand.source == Operand::Source::Register) m_busy[operand.index] = false;
+    }
+
+    Expression& m_program;
+    std::string_view m_text;
+    size_t m_pos{};
+    std::vector<Node> m_nodes;
+    std::vector<bool> m_busy;  // registers holding a value still to be read
+};
+
+Expression::Expression(std::string_view formula, std::vector<std::string> variables)
+    : m_variables(std::move(variables)) {
+    for (size_t i = 0; i < m_variables.size(); ++i) {
+        const std::string& name = m_variables[i];
+        if (name.empty() || !is_name_start(name[0]) || !std::all_of(name.begin(), name.end(), is_name_char)) {
+            throw std::invalid_argument("Invalid variable name '" + name + "'");
+        }
+        if (std::find(m_variables.begin(), m_variables.begin() + i, name) != m_variables.begin() + i) {
+            throw std::invalid_argument("Duplicate variable name '" + name + "'");
+        }
+    }
+    Compiler(*this, formula).compile();
+}
+
+const std::vector<std::string>& Expression::variables() const { return m_variables; }
+size_t Expression::instructions() const { return m_code.size(); }
+bool Expression::is_constant() const { return m_result.source == Operand::Source::Constant; }
+
+// The scalar meaning of every operation: used for folding, single rows, and by the batch loops
+double Expression::apply(const Op op, const double a, const double b, const int exponent) {
+    switch (op) {
+    case Op::Add: return a + b;
+    case Op::Subtract: return a - b;
+    case Op::Multiply: return a * b;
+    case Op::Divide: return a / b;
+    case Op::Modulo: return std::fmod(a, b);
+    case Op::Power: return std::pow(a, b);
+    case Op::PowerInt: return detail::vmath::powi(a, exponent);
+    case Op::Negate: return -a;
+    case Op::Sqrt: return std::sqrt(a);
+    case Op::Cbrt: return detail::vmath::cbrt(a);
+    case Op::Abs: return std::fabs(a);
+    case Op::Exp: return std::exp(a);
+    case Op::Ln: return std::log(a);
+    case Op::Log10: return std::log10(a);
+    case Op::Log2: return std::log2(a);
+    case Op::Sin: return std::sin(a);
+    case Op::Cos: return std::cos(a);
+    case Op::Tan: return std::tan(a);
+    case Op::Asin: return std::asin(a);
+    case Op::Acos: return std::acos(a);
+    case Op::Atan: return std::atan(a);
+    case Op::Floor: return std::floor(a);
+    case Op::Ceil: return std::ceil(a);
+    case Op::Round: return std::round(a);
+    case Op::Min: return std::fmin(a, b);
+    case Op::Max: return std::fmax(a, b);
+    case Op::Atan2: return std::atan2(a, b);
+    case Op::Hypot: return std::hypot(a, b);
+    }
+    return 0.0;
+}
+
+double Expression::evaluate(std::span<const double> values) const {
+    if (values.size() != m_variables.size()) {
+        throw std::invalid_argument("Expected one value per variable");
+    }
+    std::array<double, STACK_REGISTERS> stack;
+    std::vector<double> heap;
+    double* registers = stack.data();
+    if (m_registers > STACK_REGISTERS) {
+        heap.resize(m_registers);
+        registers = heap.data();
+    }
+    const auto read = [&](const Operand operand) {
+        switch (operand.source) {
+        case Operand::Source::Register: return registers[operand.index];
+        case Operand::Source::Variable: return values[operand.index];
+        case Operand::Source::Constant: break;
+        }
+        return m_constants[operand.index];
+    };
+    for (const Instruction& in : m_code) registers[in.target] = apply(in.op, read(in.a), read(in.b), in.exponent);
+    return read(m_result);
+}
+
+namespace {
+
+template <typename F>
+void each(const double* a, const double* b, double* out, const size_t n, F f) {
+    for (size_t i = 0; i < n; ++i) out[i] = f(a[i], b[i]);
+}
+
+} // namespace
+
+// Evaluates rows [lo, hi) block by block. scratch holds m_registers blocks followed by one
+// filled block per constant. The last instruction produces the result, so it writes to out.
+void Expression::run(std::span<const std::span<const double>> columns, const size_t lo, const size_t hi,
+                     double* out, double* scratch) const {
+    const double* constants = scratch + m_registers * BATCH;
+    for (size_t row = lo; row < hi; row += BATCH) {
+        const size_t n = std::min(BATCH, hi - row);
+        const auto source = [&](const Operand operand) -> const double* {
+            switch (operand.source) {
+            case Operand::Source::Register: return scratch + operand.index * BATCH;
+            case Operand::Source::Variable: return columns[operand.index].data() + row;
+            case Operand::Source::Constant: break;
+            }
+            return constants + operand.index * BATCH;
+        };
+        for (size_t k = 0; k < m_code.size(); ++k) {
+            const Instruction& in = m_code[k];
+            const double* a = source(in.a);
+            const double* b = source(in.b);
+            double* target = k + 1 == m_code.size() ? out + row : scratch + in.target * BATCH;
+            switch (in.op) {
+            // Kernels with their own vectorized implementation
+            case Op::Sqrt: detail::vmath::sqrt(a, target, n); break;
+            case Op::Cbrt: detail::vmath::cbrt(a, target, n); break;
+            case Op::PowerInt: detail::vmath::powi(a, in.exponent, target, n); break;
+            // Plain loops the compiler vectorizes
+            case Op::Add: each(a, b, target, n, [](double x, double y) { return x + y; }); break;
+            case Op::Subtract: each(a, b, target, n, [](double x, double y) { return x - y; }); break;
+            case Op::Multiply: each(a, b, target, n, [](double x, double y) { return x * y; }); break;
+            case Op::Divide: each(a, b, target, n, [](double x, double y) { return x / y; }); break;
+            case Op::Negate: each(a, b, target, n, [](double x, double) { return -x; }); break;
+            case Op::Abs: each(a, b, target, n, [](double x, double) { return std::fabs(x); }); break;
+            case Op::Floor: each(a, b, target, n, [](double x, double) { return std::floor(x); }); break;
+            case Op::Ceil: each(a, b, target, n, [](double x, double) { return std::ceil(x); }); break;
+            // Library calls, one element at a time
+            default:
+                for (size_t i = 0; i < n; ++i) target[i] = apply(in.op, a[i], b[i], in.exponent);
+                break;
+            }
+        }
+    }
+}
+
+void Expression::evaluate(std::span<const std::span<const double>> columns, std::span<double> out) const {
+    if (columns.size() != m_variables.size()) {
+        throw std::invalid_argument("Expected one column per variable");
+    }
+    for (const auto& column : columns) {
+        if (column.size() != out.size()) {
+            throw std::invalid_argument("Every column must have one value per output row");
+        }
+    }
+    if (m_code.empty()) {
+        if (m_result.source == Operand::Source::Constant) {
+            std::fill(out.begin(), out.end(), m_constants[m_result.index]);
+        } else if (columns[m_result.index].data() != out.data()) {
+            std::copy(columns[m_result.index].begin(), columns[m_result.index].end(), out.begin());
+        }
+        return;
+    }
+    const size_t grain = std::max(BATCH, PARALLEL_WORK / m_code.size());
+    detail::parallel_for(0, out.size(), grain, [&](size_t lo, size_t hi) {
+        std::vector<double> scratch((m_registers + m_constants.size()) * BATCH);
+        for (size_t c = 0; c < m_constants.size(); ++c)
+            std::fill_n(scratch.begin() + static_cast<std::ptrdiff_t>((m_registers + c) * BATCH), BATCH, m_constants[c]);
+        run(columns, lo, hi, out.data(), scratch.data());
+    });
+}
+
+std::vector<double> Expression::evaluate(std::span<const std::span<const double>> columns) const {
+    const size_t rows = columns.empty() ? 0 : columns.front().size();
+    std::vector<double> out(rows);
+    evaluate(columns, out);
+    return out;
+}
+
+} // namespace imeth
@@ -0,0 +1,259 @@
+#include "../include/imeth/operation/histogram.hpp"
+#include "../detail/parallel.hpp"
+#include <algorithm>
+#include <bit>
+#include <cmath>
+#include <limits>
+#include <mutex>
+#include <stdexcept>
+
+namespace imeth::Statistics {
+
+namespace {
+
+// Values per thread below which a push is counted on the calling thread
+constexpr size_t PARALLEL_GRAIN = size_t{1} << 20;
+// Values whose candidate slots are computed in one vectorizable pass before counting
+constexpr size_t CHUNK = 1024;
+// Interleaved counter copies, so runs of equal slots do not wait on each other's stores
+constexpr size_t LANES = 4;
+// Slots per copy that keep all LANES copies within a 32 KiB L1 cache
+constexpr size_t LANE_SLOTS = (size_t{32} << 10) / (LANES * sizeof(std::uint64_t));
+// Candidate slots are int32 so the conversion vectorizes on every ISA
+constexpr size_t MAX_COMPUTED_BINS = std::numeric_limits<std::int32_t>::max() - 2;
+
+// Values searched in lockstep, so the dependent loads of several binary searches overlap
+constexpr size_t SEARCH_GROUP = 8;
+
+// log2 of a positive normal double to about 1e-9: split off the exponent k so the mantissa m
+// is in [sqrt(1/2), sqrt(2)), then log(m) = 2 atanh(s) with s = (m - 1) / (m + 1), |s| <= 0.172.
+// Only logical shifts and a magic-number int-to-double conversion, so loops over it vectorize
+// without AVX-512. It only guesses a bin, which is then checked against the exact edges.
+inline double fast_log2(const double x) {
+    constexpr std::uint64_t SQRT_HALF = 0x3FE6A09E667F3BCDull, BIAS = 1024ull << 52;
+    const std::uint64_t bits = std::bit_cast<std::uint64_t>(x);
+    const std::uint64_t biased_k = (bits - SQRT_HALF + BIAS) >> 52;  // k + 1024, never negative
+    const double m = std::bit_cast<double>(bits - ((biased_k - 1024) << 52));
+    const double k = std::bit_cast<double>(biased_k | 0x4330000000000000ull) - (4503599627370496.0 + 1024.0);
+    const double s = (m - 1.0) / (m + 1.0);
+    const double s2 = s * s;
+    const double series = 1.0 + s2 * (1.0 / 3 + s2 * (1.0 / 5 + s2 * (1.0 / 7 + s2 * (1.0 / 9))));
+    constexpr double TWO_OVER_LN2 = 2.8853900817779268;
+    return k + s * series * TWO_OVER_LN2;
+}
+
+} // namespace
+
+Histogram::Histogram(std::vector<double> edges) : Histogram(Layout::Edges, std::move(edges)) {}
+
+Histogram::Histogram(const Layout layout, std::vector<double> edges) : m_layout(layout), m_edges(std::move(edges)) {
+    if (m_edges.size() < 2) {
+        throw std::invalid_argument("A histogram needs at least two edges");
+    }
+    for (size_t i = 0; i < m_edges.size(); ++i) {
+        if (!std::isfinite(m_edges[i]) || (i > 0 && !(m_edges[i - 1] < m_edges[i]))) {
+            throw std::invalid_argument("Histogram edges must be finite and strictly increasing");
+        }
+    }
+    const double bins = static_cast<double>(m_edges.size() - 1);
+    if (layout == Layout::Uniform) {
+        m_origin = m_edges.front();
+        m_scale = bins / (m_edges.back() - m_edges.front());
+    } else if (layout == Layout::Logarithmic) {
+        m_origin = std::log2(m_edges.front());
+        m_scale = bins / (std::log2(m_edges.back()) - m_origin);
+    }
+    constexpr double NaN = std::numeric_limits<double>::quiet_NaN();
+    m_bounds.reserve(m_edges.size() + 3);
+    m_bounds.push_back(NaN);
+    m_bounds.insert(m_bounds.end(), m_edges.begin(), m_edges.end());
+    m_bounds.insert(m_bounds.end(), {NaN, NaN});
+    m_slots.assign(m_edges.size() + 1, 0);
+}
+
+Histogram Histogram::uniform(const double low, const double high, const size_t bins) {
+    if (!(low < high) || !std::isfinite(high - low)) {
+        throw std::invalid_argument("Histogram range must satisfy low < high");
+    }
+    if (bins == 0 || bins > MAX_COMPUTED_BINS) {
+        throw std::invalid_argument("Histogram bin count out of range");
+    }
+    std::vector<double> edges(bins + 1);
+    for (size_t i = 0; i < bins; ++i)
+        edges[i] = low + (high - low) * (static_cast<double>(i) / static_cast<double>(bins));
+    edges[bins] = high;
+    return Histogram(Layout::Uniform, std::move(edges));
+}
+
+Histogram Histogram::logarithmic(const double low, const double high, const size_t bins) {
+    if (!(low >= std::numeric_limits<double>::min()) || !(low < high) || !std::isfinite(high)) {
+        throw std::invalid_argument("Logarithmic histogram range must satisfy 0 < low < high");
+    }
+    if (bins == 0 || bins > MAX_COMPUTED_BINS) {
+        throw std::invalid_argument("Histogram bin count out of range");
+    }
+    const double first = std::log2(low), step = (std::log2(high) - first) / static_cast<double>(bins);
+    std::vector<double> edges(bins + 1);
+    edges[0] = low;
+    for (size_t i = 1; i < bins; ++i) edges[i] = std::exp2(first + step * static_cast<double>(i));
+    edges[bins] = high;
+    return Histogram(Layout::Logarithmic, std::move(edges));
+}
+
+size_t Histogram::slot(const double value) const {
+    std::int32_t s;
+    locate(&value, 1, &s);
+    return static_cast<size_t>(s);
+}
+
+// Slots of n values. Uniform and logarithmic layouts guess every slot in a branch-free loop
+// the compiler vectorizes, then move each guess to the exact edge count: comparisons with NaN
+// are false, so the NaN padding of m_bounds stops the walk at both ends without bounds checks.
+// The guess is off by at most one unless bins are narrower than its rounding error.
+void Histogram::locate(const double* values, const size_t n, std::int32_t* slots) const {
+    const size_t bins = m_edges.size() - 1;
+    const double* bounds = m_bounds.data();
+    const double top = m_edges.back();
+    const auto nan_slot = static_cast<std::int32_t>(bins + 2);
+
+    if (m_layout == Layout::Edges) {
+        for (size_t i0 = 0; i0 < n; i0 += SEARCH_GROUP) {
+            const size_t group = std::min(SEARCH_GROUP, n - i0);
+            const double* x = values + i0;
+            const double* edges = m_edges.data();
+            size_t base[SEARCH_GROUP] = {};
+            // Halve the range with a conditional move instead of a branch
+            for (size_t len = bins + 1; len > 1; len -= len / 2)
+                for (size_t j = 0; j < group; ++j)
+                    base[j] = edges[base[j] + len / 2] <= x[j] ? base[j] + len / 2 : base[j];
+            for (size_t j = 0; j < group; ++j) {
+                const size_t s = base[j] + (edges[base[j]] <= x[j]) - (x[j] == top);
+                slots[i0 + j] = x[j] == x[j] ? static_cast<std::int32_t>(s) : nan_slot;
+            }
+        }
+        return;
+    }
+
+    const double low = m_edges.front(), origin = m_origin, scale = m_scale, last = static_cast<double>(bins);
+    // std::max(-1.0, NaN) is -1, so the conversions are always defined; NaN is sorted out
+    // in the scalar pass, a test in these loops would stop them vectorizing
+    if (m_layout == Layout::Uniform) {
+        for (size_t i = 0; i < n; ++i) {
+            const double t = std::min(last, std::max(-1.0, (values[i] - origin) * scale));
+            slots[i] = static_cast<std::int32_t>(t + 1.0);
+        }
+    } else {
+        for (size_t i = 0; i < n; ++i) {
+            const double t = std::min(last, std::max(-1.0, (fast_log2(std::max(low, values[i])) - origin) * scale));
+            slots[i] = static_cast<std::int32_t>(t + 1.0);
+        }
+    }
+    for (size_t i = 0; i < n; ++i) {
+        const double x = values[i];
+        std::int32_t s = slots[i];
+        while (x < bounds[s]) --s;
+        while (x >= bounds[s + 1]) ++s;
+        slots[i] = x == x ? s - (x == top) : nan_slot;
+    }
+}
+
+// Adds the counts of values to slots[0, bins() + 2). With few bins a chunk of located slots
+// is counted into LANES interleaved copies of the counters; zeroing and folding the copies
+// costs O(bins), so with many bins, or few values, the count goes straight into slots.
+void Histogram::count_into(std::span<const double> values, std::uint64_t* slots) const {
+    const size_t width = m_edges.size() + 2;  // one more slot, for NaN
+    const bool interleave = width <= LANE_SLOTS && LANES * width <= values.size();
+    std::uint64_t lanes[LANES * LANE_SLOTS];
+    if (interleave) std::fill(lanes, lanes + LANES * width, 0);
+    const auto nan_slot = static_cast<std::int32_t>(width - 1);
+    std::int32_t located[CHUNK];
+    for (size_t c0 = 0; c0 < values.size(); c0 += CHUNK) {
+        const size_t len = std::min(CHUNK, values.size() - c0);
+        locate(values.data() + c0, len, located);
+        if (!interleave) {
+            for (size_t i = 0; i < len; ++i)
+                if (located[i] != nan_slot) ++slots[located[i]];
+            continue;
+        }
+        size_t i = 0;
+        for (; i + LANES <= len; i += LANES)
+            for (size_t lane = 0; lane < LANES; ++lane) ++lanes[lane * width + located[i + lane]];
+        for (; i < len; ++i) ++lanes[located[i]];
+    }
+    if (!interleave) return;
+    for (size_t lane = 0; lane < LANES; ++lane)
+        for (size_t s = 0; s + 1 < width; ++s) slots[s] += lanes[lane * width + s];
+}
+
+void Histogram::push(const double value) {
+    if (std::isnan(value)) return;
+    ++m_slots[slot(value)];
+}
+
+// Each worker takes one contiguous part and counts it into its own private counters, allocated
+// once for the whole part. Private counters only pay off while there are more values per
+// worker than counters; otherwise the calling thread counts everything into m_slots.
+void Histogram::push(std::span<const double> values) {
+    if (values.size() < 2 * PARALLEL_GRAIN || m_slots.size() > PARALLEL_GRAIN) {
+        count_into(values, m_slots.data());
+        return;
+    }
+    std::mutex lock;
+    detail::parallel_for(0, values.size(), PARALLEL_GRAIN, [&](size_t lo, size_t hi) {
+        std::vector<std::uint64_t> local(m_slots.size(), 0);
+        count_into(values.subspan(lo, hi - lo), local.data());
+        const std::lock_guard guard(lock);
+        for (size_t s = 0; s < local.size(); ++s) m_slots[s] += local[s];
+    });
+}
+
+void Histogram::merge(const Histogram& other) {
+    if (m_edges != other.m_edges) {
+        throw std::invalid_argument("Cannot merge histograms with different bins");
+    }
+    for (size_t s = 0; s < m_slots.size(); ++s) m_slots[s] += other.m_slots[s];
+}
+
+Histogram& Histogram::operator+=(const Histogram& other) {
+    merge(other);
+    return *this;
+}
+
+void Histogram::reset() {
+    std::fill(m_slots.begin(), m_slots.end(), 0);
+}
+
+size_t Histogram::bins() const { return m_edges.size() - 1; }
+const std::vector<double>& Histogram::edges() const { return m_edges; }
+std::span<const std::uint64_t> Histogram::counts() const { return std::span(m_slots).subspan(1, bins()); }
+
+std::uint64_t Histogram::count(const size_t bin) const {
+    if (bin >= bins()) {
+        throw std::out_of_range("Histogram bin index out of range");
+    }
+    return m_slots[bin + 1];
+}
+
+std::uint64_t Histogram::underflow() const { return m_slots.front(); }
+std::uint64_t Histogram::overflow() const { return m_slots.back(); }
+
+std::uint64_t Histogram::total() const {
+    std::uint64_t total = 0;
+    for (const std::uint64_t c : m_slots) total += c;
+    return total;
+}
+
+size_t Histogram::bin(const double value) const {
+    const size_t s = slot(value);
+    if (s == 0 || s > bins()) {
+        throw std::out_of_range("Value is outside the histogram range");
+    }
+    return s - 1;
+}
+
+Histogram operator+(Histogram lhs, const Histogram& rhs) {
+    lhs.merge(rhs);
+    return lhs;
+}
+
+} // namespace imeth::Statistics
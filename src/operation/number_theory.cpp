@@ -0,0 +1,432 @@
+#include "../include/imeth/operation/number_theory.hpp"
+#include "../detail/parallel.hpp"
+#include "../detail/reduce.hpp"
+#include "../detail/wide.hpp"
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <bit>
+#include <cmath>
+#include <cstring>
+#include <stdexcept>
+
+namespace imeth::NumberTheory {
+
+namespace {
+
+// Odd numbers per segment, one byte each: 128 KiB stays in L2 while every sieving prime
+// walks over it
+constexpr size_t SEGMENT = size_t{1} << 17;
+// Segments each thread sieves per window of for_each_prime / primes
+constexpr size_t SEGMENTS_PER_THREAD = 4;
+
+// Multiples of the wheel primes repeat every 3 * 5 * 7 * 11 * 13 odd numbers
+constexpr std::array<std::uint32_t, 5> WHEEL_PRIMES = {3, 5, 7, 11, 13};
+constexpr size_t WHEEL_PERIOD = 15015;
+
+constexpr std::uint64_t SMALL_LIMIT = std::uint64_t{1} << 21;
+
+// Trial divisors before Miller-Rabin, and bases that make it exact below 2^64 (Sinclair)
+constexpr std::array<std::uint64_t, 11> TRIAL_PRIMES = {3, 5, 7, 11, 13, 17, 19, 23, 29, 31, 37};
+constexpr std::array<std::uint64_t, 7> WITNESSES = {2, 325, 9375, 28178, 450775, 9780504, 1795265022};
+
+std::uint64_t isqrt(std::uint64_t n) {
+    auto r = static_cast<std::uint64_t>(std::sqrt(static_cast<double>(n)));
+    while (r * r > n) --r;
+    while ((r + 1) * (r + 1) <= n) ++r;
+    return r;
+}
+
+// wheel[k] is 0 when 2k + 1 is a multiple of a wheel prime
+const std::array<std::uint8_t, WHEEL_PERIOD>& wheel() {
+    static const auto pattern = [] {
+        std::array<std::uint8_t, WHEEL_PERIOD> p;
+        p.fill(1);
+        for (const std::uint32_t q : WHEEL_PRIMES)
+            for (size_t k = (q - 1) / 2; k < WHEEL_PERIOD; k += q) p[k] = 0;
+        return p;
+    }();
+    return pattern;
+}
+
+// Odd primes above the wheel up to `limit`, by a plain odd-only sieve
+std::vector<std::uint32_t> sieving_primes(std::uint64_t limit) {
+    std::vector<std::uint32_t> result;
+    if (limit < 17) return result;
+    std::vector<std::uint8_t> composite(limit / 2 + 1, 0);
+    for (std::uint64_t p = 3; p * p <= limit; p += 2)
+        if (!composite[p / 2])
+            for (std::uint64_t m = p * p; m <= limit; m += 2 * p) composite[m / 2] = 1;
+    for (std::uint64_t p = 17; p <= limit; p += 2)
+        if (!composite[p / 2]) result.push_back(static_cast<std::uint32_t>(p));
+    return result;
+}
+
+// The odd numbers 2k + 1 in [low, high], split into segments of SEGMENT indices
+class OddSieve {
+public:
+    OddSieve(std::uint64_t low, std::uint64_t high) {
+        if (high >= max_sieve_limit)
+            throw std::invalid_argument("Sieve range must stay below 2^50");
+        m_begin = low / 2;                       // first k with 2k + 1 >= low
+        m_end = high == 0 ? 0 : (high - 1) / 2 + 1;
+        if (m_end < m_begin) m_end = m_begin;
+        m_primes = sieving_primes(isqrt(high));
+    }
+
+    size_t segments() const { return static_cast<size_t>((m_end - m_begin + SEGMENT - 1) / SEGMENT); }
+    std::uint64_t begin_index() const { return m_begin; }
+
+    // Sieves segments [first, last) in order and calls visit(k0, flags, length) for each;
+    // flags[j] is 1 exactly when 2 (k0 + j) + 1 is prime
+    template <typename Visit>
+    void run(size_t first, size_t last, Visit&& visit) const {
+        if (first >= last) return;
+        std::vector<std::uint8_t> flags(SEGMENT);
+        const auto& pattern = wheel();
+
+        // Next index to cross off for each prime; only the first segment needs a division
+        std::vector<std::uint64_t> next(m_primes.size());
+        const std::uint64_t start = m_begin + first * SEGMENT;
+        for (size_t i = 0; i < m_primes.size(); ++i) {
+            const std::uint64_t p = m_primes[i];
+            std::uint64_t q = (2 * start + 1 + p - 1) / p;
+            q |= 1;  // odd multiples only
+            next[i] = (std::max(q, p) * p - 1) / 2;
+        }
+
+        for (size_t s = first; s < last; ++s) {
+            const std::uint64_t k0 = m_begin + s * SEGMENT;
+            const size_t length = static_cast<size_t>(std::min<std::uint64_t>(SEGMENT, m_end - k0));
+
+            // Stamp the wheel pattern, starting at the right phase
+            size_t filled = 0;
+            size_t phase = static_cast<size_t>(k0 % WHEEL_PERIOD);
+            while (filled < length) {
+                const size_t chunk = std::min(length - filled, WHEEL_PERIOD - phase);
+                std::memcpy(flags.data() + filled, pattern.data() + phase, chunk);
+                filled += chunk;
+                phase = 0;
+            }
+            // The pattern clears the wheel primes themselves and leaves 1 set
+            if (k0 < WHEEL_PRIMES.back()) {
+                for (const std::uint32_t q : WHEEL_PRIMES)
+                    if ((q - 1) / 2 >= k0 && (q - 1) / 2 < k0 + length) flags[(q - 1) / 2 - k0] = 1;
+                if (k0 == 0) flags[0] = 0;
+            }
+
+            const std::uint64_t k1 = k0 + length;
+            for (size_t i = 0; i < m_primes.size(); ++i) {
+                const std::uint64_t p = m_primes[i];
+                if ((p * p - 1) / 2 >= k1) break;  // neither this prime nor larger ones reach here
+                std::uint64_t k = next[i];
+                for (; k < k1; k += p) flags[k - k0] = 0;
+                next[i] = k;
+            }
+            visit(k0, flags.data(), length);
+        }
+    }
+
+private:
+    std::uint64_t m_begin{};
+    std::uint64_t m_end{};
+    std::vector<std::uint32_t> m_primes;
+};
+
+std::uint64_t count_flags(const std::uint8_t* flags, size_t length) {
+    std::uint64_t total = 0;
+    for (size_t j = 0; j < length; ++j) total += flags[j];
+    return total;
+}
+
+// Runs the sieve over [low, high] in windows of a few segments per thread and hands each
+// window's primes, in ascending order, to deliver(const std::vector<std::uint64_t>&)
+template <typename Deliver>
+void enumerate(std::uint64_t low, std::uint64_t high, Deliver&& deliver) {
+    if (low > high) return;
+    std::vector<std::uint64_t> two;
+    if (low <= 2 && high >= 2) two.push_back(2);
+    if (!two.empty()) deliver(two);
+    if (high < 3) return;
+
+    const OddSieve sieve(std::max<std::uint64_t>(low, 3), high);
+    const size_t total = sieve.segments();
+    const size_t window = std::max<size_t>(1, detail::thread_count() * SEGMENTS_PER_THREAD);
+    std::vector<std::vector<std::uint64_t>> found(std::min(window, total));
+
+    for (size_t w = 0; w < total; w += window) {
+        const size_t count = std::min(window, total - w);
+        detail::parallel_for(0, count, 1, [&](size_t lo, size_t hi) {
+            sieve.run(w + lo, w + hi, [&](std::uint64_t k0, const std::uint8_t* flags, size_t length) {
+                auto& out = found[static_cast<size_t>((k0 - sieve.begin_index()) / SEGMENT - w)];
+                // Branch-free compaction: always store, advance by the flag
+                out.resize(length);
+                size_t n = 0;
+                for (size_t j = 0; j < length; ++j) {
+                    out[n] = 2 * (k0 + j) + 1;
+                    n += flags[j];
+                }
+                out.resize(n);
+            });
+        });
+        for (size_t i = 0; i < count; ++i) deliver(found[i]);
+    }
+}
+
+void require_same_size(size_t a, size_t b, size_t out) {
+    if (a != b || a != out) {
+        throw std::invalid_argument("Input and output sizes differ");
+    }
+}
+
+// Primes below this are removed by trial division before Pollard's rho
+constexpr std::uint64_t TRIAL_LIMIT = 1024;
+// Products of this many differences share one GCD in Brent's loop
+constexpr std::uint64_t RHO_BATCH = 128;
+
+// A nontrivial factor of an odd composite n, or n itself when the walk for this c closes a
+// cycle without finding one (the caller then retries with another c)
+std::uint64_t brent_rho(std::uint64_t n, std::uint64_t c_seed) {
+    const detail::wide::Montgomery mont(n);
+    const std::uint64_t c = mont.to(c_seed);
+    auto step = [&](std::uint64_t v) { return mont.add(mont.multiply(v, v), c); };
+    auto distance = [](std::uint64_t a, std::uint64_t b) { return a > b ? a - b : b - a; };
+
+    // Values stay in Montgomery form: gcd(x * R mod n, n) = gcd(x, n) since R is a unit
+    std::uint64_t y = mont.to(2), x = y, saved = y;
+    std::uint64_t q = mont.one(), g = 1;
+    for (std::uint64_t r = 1; g == 1; r *= 2) {
+        x = y;
+        for (std::uint64_t i = 0; i < r; ++i) y = step(y);
+        for (std::uint64_t k = 0; k < r && g == 1; k += RHO_BATCH) {
+            saved = y;
+            for (std::uint64_t i = 0; i < std::min(RHO_BATCH, r - k); ++i) {
+                y = step(y);
+                q = mont.multiply(q, distance(x, y));
+            }
+            g = gcd(q, n);
+        }
+    }
+    if (g == n) {
+        // The batch overshot; replay it one step at a time
+        do {
+            saved = step(saved);
+            g = gcd(distance(x, saved), n);
+        } while (g == 1);
+    }
+    return g;
+}
+
+void factor_large(std::uint64_t n, std::vector<std::uint64_t>& out) {
+    if (is_prime(n)) {
+        out.push_back(n);
+        return;
+    }
+    std::uint64_t d = n;
+    for (std::uint64_t c = 1; d == n; ++c) d = brent_rho(n, c);
+    factor_large(d, out);
+    factor_large(n / d, out);
+}
+
+bool miller_rabin(std::uint64_t n) {
+    const detail::wide::Montgomery mont(n);
+    std::uint64_t d = n - 1;
+    const int s = std::countr_zero(d);
+    d >>= s;
+    const std::uint64_t one = mont.one();
+    const std::uint64_t minus_one = n - one;
+
+    for (const std::uint64_t witness : WITNESSES) {
+        const std::uint64_t a = witness % n;
+        if (a == 0) continue;
+        std::uint64_t x = mont.power(mont.to(a), d);
+        if (x == one || x == minus_one) continue;
+        bool composite = true;
+        for (int r = 1; r < s && composite; ++r) {
+            x = mont.multiply(x, x);
+            if (x == minus_one) composite = false;
+        }
+        if (composite) return false;
+    }
+    return true;
+}
+
+} // namespace
+
+bool is_prime(const std::uint64_t n) {
+    if (n <= SMALL_LIMIT) return small_primes().contains(n);
+    if (n % 2 == 0) return false;
+    for (const std::uint64_t p : TRIAL_PRIMES)
+        if (n % p == 0) return false;
+    return miller_rabin(n);
+}
+
+std::uint64_t gcd(std::uint64_t a, std::uint64_t b) {
+    if (a == 0) return b;
+    if (b == 0) return a;
+    const int shift = std::countr_zero(a | b);
+    a >>= std::countr_zero(a);
+    while (b != 0) {
+        b >>= std::countr_zero(b);
+        // Both odd now; the difference is even, and its zeros go on the next round
+        if (a > b) std::swap(a, b);
+        b -= a;
+    }
+    return a << shift;
+}
+
+std::uint64_t lcm(const std::uint64_t a, const std::uint64_t b) {
+    if (a == 0 || b == 0) return 0;
+    const auto product = detail::wide::mul(a / gcd(a, b), b);
+    if (product.hi != 0) {
+        throw std::overflow_error("Least common multiple does not fit in 64 bits");
+    }
+    return product.lo;
+}
+
+std::uint64_t gcd(std::span<const std::uint64_t> values) {
+    std::vector<std::uint64_t> partial((values.size() + detail::reduce::BLOCK - 1) / detail::reduce::BLOCK, 0);
+    std::atomic<bool> coprime{false};
+    detail::reduce::for_each_block(values.size(), [&](size_t b, size_t lo, size_t hi) {
+        std::uint64_t g = 0;
+        for (size_t i = lo; i < hi && g != 1; ++i) g = gcd(g, values[i]);
+        partial[b] = g;
+        if (g == 1) coprime.store(true, std::memory_order_relaxed);
+    });
+    if (coprime.load()) return 1;
+    std::uint64_t g = 0;
+    for (const std::uint64_t p : partial) g = gcd(g, p);
+    return g;
+}
+
+std::uint64_t lcm(std::span<const std::uint64_t> values) {
+    std::vector<std::uint64_t> partial((values.size() + detail::reduce::BLOCK - 1) / detail::reduce::BLOCK, 1);
+    detail::reduce::for_each_block(values.size(), [&](size_t b, size_t lo, size_t hi) {
+        std::uint64_t l = 1;
+        for (size_t i = lo; i < hi && l != 0; ++i) l = lcm(l, values[i]);
+        partial[b] = l;
+    });
+    std::uint64_t l = 1;
+    for (const std::uint64_t p : partial) l = lcm(l, p);
+    return l;
+}
+
+void gcd(std::span<const std::uint64_t> a, std::span<const std::uint64_t> b, std::span<std::uint64_t> out) {
+    require_same_size(a.size(), b.size(), out.size());
+    detail::reduce::for_each_block(a.size(), [&](size_t, size_t lo, size_t hi) {
+        for (size_t i = lo; i < hi; ++i) out[i] = gcd(a[i], b[i]);
+    });
+}
+
+void lcm(std::span<const std::uint64_t> a, std::span<const std::uint64_t> b, std::span<std::uint64_t> out) {
+    require_same_size(a.size(), b.size(), out.size());
+    detail::reduce::for_each_block(a.size(), [&](size_t, size_t lo, size_t hi) {
+        for (size_t i = lo; i < hi; ++i) out[i] = lcm(a[i], b[i]);
+    });
+}
+
+std::vector<std::uint64_t> factorize(std::uint64_t n) {
+    if (n == 0) {
+        throw std::invalid_argument("Cannot factorize zero");
+    }
+    std::vector<std::uint64_t> factors;
+    const int twos = std::countr_zero(n);
+    factors.assign(static_cast<size_t>(twos), 2);
+    n >>= twos;
+
+    const auto& table = small_primes();
+    for (std::uint64_t p = 3; p < TRIAL_LIMIT && p * p <= n; p += 2) {
+        if (!table.contains(p)) continue;
+        while (n % p == 0) {
+            factors.push_back(p);
+            n /= p;
+        }
+    }
+    if (n == 1) return factors;
+    if (n < TRIAL_LIMIT * TRIAL_LIMIT) {
+        factors.push_back(n);  // no factor below its square root is left
+        return factors;
+    }
+
+    const size_t small = factors.size();
+    factor_large(n, factors);
+    std::sort(factors.begin() + static_cast<std::ptrdiff_t>(small), factors.end());
+    return factors;
+}
+
+std::uint64_t count_primes(const std::uint64_t high) {
+    return count_primes(0, high);
+}
+
+std::uint64_t count_primes(const std::uint64_t low, const std::uint64_t high) {
+    if (low > high) return 0;
+    std::uint64_t result = low <= 2 && high >= 2 ? 1 : 0;
+    if (high < 3) return result;
+
+    const OddSieve sieve(std::max<std::uint64_t>(low, 3), high);
+    std::atomic<std::uint64_t> total{0};
+    detail::parallel_for(0, sieve.segments(), 1, [&](size_t lo, size_t hi) {
+        std::uint64_t local = 0;
+        sieve.run(lo, hi, [&](std::uint64_t, const std::uint8_t* flags, size_t length) {
+            local += count_flags(flags, length);
+        });
+        total.fetch_add(local, std::memory_order_relaxed);
+    });
+    return result + total.load();
+}
+
+std::vector<std::uint64_t> primes(const std::uint64_t high) {
+    return primes(0, high);
+}
+
+std::vector<std::uint64_t> primes(const std::uint64_t low, const std::uint64_t high) {
+    std::vector<std::uint64_t> result;
+    enumerate(low, high, [&](const std::vector<std::uint64_t>& batch) {
+        result.insert(result.end(), batch.begin(), batch.end());
+    });
+    return result;
+}
+
+void for_each_prime(const std::uint64_t low, const std::uint64_t high,
+                    const std::function<void(std::uint64_t)>& fn) {
+    enumerate(low, high, [&](const std::vector<std::uint64_t>& batch) {
+        for (const std::uint64_t p : batch) fn(p);
+    });
+}
+
+PrimeTable::PrimeTable(const std::uint64_t limit) : m_limit(limit) {
+    m_bits.assign(static_cast<size_t>(limit / 128 + 1), 0);
+    m_count = limit >= 2 ? 1 : 0;
+    if (limit < 3) return;
+
+    // Starts at index 0 and SEGMENT is a multiple of 64, so segments fill disjoint words
+    const OddSieve sieve(0, limit);
+    detail::parallel_for(0, sieve.segments(), 1, [&](size_t lo, size_t hi) {
+        sieve.run(lo, hi, [&](std::uint64_t k0, const std::uint8_t* flags, size_t length) {
+            for (size_t j = 0; j < length; ++j) {
+                const std::uint64_t k = k0 + j;
+                m_bits[static_cast<size_t>(k / 64)] |= static_cast<std::uint64_t>(flags[j]) << (k % 64);
+            }
+        });
+    });
+    for (const std::uint64_t word : m_bits) m_count += static_cast<std::uint64_t>(std::popcount(word));
+}
+
+bool PrimeTable::contains(const std::uint64_t n) const {
+    if (n > m_limit) {
+        throw std::out_of_range("Number is outside the prime table");
+    }
+    if (n % 2 == 0) return n == 2;
+    const std::uint64_t k = n / 2;
+    return (m_bits[static_cast<size_t>(k / 64)] >> (k % 64)) & 1;
+}
+
+std::uint64_t PrimeTable::limit() const { return m_limit; }
+std::uint64_t PrimeTable::count() const { return m_count; }
+
+const PrimeTable& small_primes() {
+    static const PrimeTable table(SMALL_LIMIT);
+    return table;
+}
+
+} // namespace imeth::NumberTheory
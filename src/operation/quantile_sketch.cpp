@@ -0,0 +1,283 @@
+#include "../include/imeth/operation/quantile_sketch.hpp"
+#include <algorithm>
+#include <bit>
+#include <cmath>
+#include <stdexcept>
+
+namespace imeth::Statistics {
+
+namespace {
+
+constexpr size_t MIN_K = 8;
+constexpr size_t MAX_K = 65535;
+constexpr size_t MIN_LEVEL_WIDTH = 8;
+constexpr double CAPACITY_DECAY = 2.0 / 3.0;
+constexpr size_t MAX_LEVELS = 64; // weights are 2^level in a 64-bit count
+
+constexpr std::uint8_t MAGIC[4] = {'I', 'K', 'L', 'L'};
+constexpr std::uint8_t FORMAT_VERSION = 1;
+
+void put_u64(std::vector<std::uint8_t>& out, std::uint64_t v, size_t bytes) {
+    for (size_t i = 0; i < bytes; ++i)
+        out.push_back(static_cast<std::uint8_t>(v >> (8 * i)));
+}
+
+void put_double(std::vector<std::uint8_t>& out, double v) {
+    put_u64(out, std::bit_cast<std::uint64_t>(v), 8);
+}
+
+class Reader {
+public:
+    explicit Reader(std::span<const std::uint8_t> bytes) : m_bytes(bytes) {}
+
+    std::uint64_t u64(size_t bytes) {
+        if (m_bytes.size() - m_pos < bytes)
+            throw std::invalid_argument("Truncated quantile sketch encoding");
+        std::uint64_t v = 0;
+        for (size_t i = 0; i < bytes; ++i)
+            v |= static_cast<std::uint64_t>(m_bytes[m_pos++]) << (8 * i);
+        return v;
+    }
+
+    double f64() { return std::bit_cast<double>(u64(8)); }
+    bool done() const { return m_pos == m_bytes.size(); }
+
+private:
+    std::span<const std::uint8_t> m_bytes;
+    size_t m_pos{};
+};
+
+} // namespace
+
+QuantileSketch::QuantileSketch(size_t k) : m_k(k) {
+    if (k < MIN_K || k > MAX_K)
+        throw std::invalid_argument("Sketch parameter k must be in [8, 65535]");
+    add_level();
+}
+
+void QuantileSketch::add_level() {
+    if (m_levels.size() == MAX_LEVELS)
+        throw std::overflow_error("Quantile sketch level limit reached");
+    m_levels.emplace_back();
+    m_level_capacity.resize(m_levels.size());
+    m_capacity = 0;
+    for (size_t h = 0; h < m_levels.size(); ++h) {
+        const double depth = static_cast<double>(m_levels.size() - h - 1);
+        const double capacity = std::ceil(static_cast<double>(m_k) * std::pow(CAPACITY_DECAY, depth));
+        m_level_capacity[h] = std::max(MIN_LEVEL_WIDTH, static_cast<size_t>(capacity));
+        m_capacity += m_level_capacity[h];
+    }
+}
+
+void QuantileSketch::push(const double value) {
+    if (std::isnan(value)) return;
+    ++m_count;
+    if (value < m_min) m_min = value;
+    if (value > m_max) m_max = value;
+    m_levels[0].push_back(value);
+    if (++m_retained >= m_capacity) compress();
+}
+
+void QuantileSketch::push(std::span<const double> values) {
+    for (const double v : values) push(v);
+}
+
+// Compacts the lowest over-full level until the sketch fits its capacity again
+void QuantileSketch::compress() {
+    while (m_retained >= m_capacity) {
+        size_t h = 0;
+        while (m_levels[h].size() < m_level_capacity[h]) ++h;
+        compact(h);
+    }
+}
+
+void QuantileSketch::compact(size_t level) {
+    if (level + 1 == m_levels.size()) add_level();
+    auto& items = m_levels[level];
+    auto& above = m_levels[level + 1];
+    std::sort(items.begin(), items.end());
+
+    // An odd value out stays behind so the promoted half has an even count
+    const size_t leftover = items.size() % 2;
+    m_random ^= m_random << 13;
+    m_random ^= m_random >> 7;
+    m_random ^= m_random << 17;
+    const size_t offset = m_random & 1;
+
+    above.reserve(above.size() + items.size() / 2);
+    for (size_t i = leftover + offset; i < items.size(); i += 2)
+        above.push_back(items[i]);
+    m_retained -= items.size() - leftover - (items.size() - leftover) / 2;
+    items.resize(leftover);
+}
+
+void QuantileSketch::merge(const QuantileSketch& other) {
+    if (other.m_k != m_k)
+        throw std::invalid_argument("Cannot merge sketches with different k");
+    if (other.m_count == 0) return;
+
+    while (m_levels.size() < other.m_levels.size()) add_level();
+    for (size_t h = 0; h < other.m_levels.size(); ++h)
+        m_levels[h].insert(m_levels[h].end(), other.m_levels[h].begin(), other.m_levels[h].end());
+    m_retained += other.m_retained;
+    m_count += other.m_count;
+    if (other.m_min < m_min) m_min = other.m_min;
+    if (other.m_max > m_max) m_max = other.m_max;
+    compress();
+}
+
+QuantileSketch& QuantileSketch::operator+=(const QuantileSketch& other) {
+    merge(other);
+    return *this;
+}
+
+void QuantileSketch::reset() {
+    *this = QuantileSketch(m_k);
+}
+
+size_t QuantileSketch::k() const { return m_k; }
+std::uint64_t QuantileSketch::count() const { return m_count; }
+bool QuantileSketch::empty() const { return m_count == 0; }
+
+size_t QuantileSketch::retained() const { return m_retained; }
+
+double QuantileSketch::normalized_rank_error() const {
+    // Empirical fit for this compactor schedule (2/3 capacity decay, minimum width 8)
+    return 2.296 / std::pow(static_cast<double>(m_k), 0.9723);
+}
+
+double QuantileSketch::minimum() const {
+    if (m_count == 0) {
+        throw std::invalid_argument("Cannot find minimum of empty list");
+    }
+    return m_min;
+}
+
+double QuantileSketch::maximum() const {
+    if (m_count == 0) {
+        throw std::invalid_argument("Cannot find maximum of empty list");
+    }
+    return m_max;
+}
+
+std::vector<std::pair<double, std::uint64_t>> QuantileSketch::sorted_view() const {
+    std::vector<std::pair<double, std::uint64_t>> view;
+    view.reserve(retained());
+    for (size_t h = 0; h < m_levels.size(); ++h)
+        for (const double v : m_levels[h])
+            view.emplace_back(v, std::uint64_t{1} << h);
+    std::sort(view.begin(), view.end());
+
+    std::uint64_t cumulative = 0;
+    for (auto& [value, weight] : view) {
+        cumulative += weight;
+        weight = cumulative;
+    }
+    return view;
+}
+
+std::vector<double> QuantileSketch::quantiles(const std::vector<double>& probabilities) const {
+    if (m_count == 0) {
+        throw std::invalid_argument("Cannot find quantile of empty list");
+    }
+    for (const double p : probabilities)
+        if (!(p >= 0.0 && p <= 1.0))
+            throw std::invalid_argument("Quantile probability must be in [0, 1]");
+
+    const auto view = sorted_view();
+    const double total = static_cast<double>(view.back().second);
+    std::vector<double> result;
+    result.reserve(probabilities.size());
+    for (const double p : probabilities) {
+        if (p == 0.0) {
+            result.push_back(m_min);
+        } else if (p == 1.0) {
+            result.push_back(m_max);
+        } else {
+            // First retained value whose cumulative weight reaches p * n
+            const double target = p * total;
+            const auto it = std::lower_bound(view.begin(), view.end(), target,
+                [](const auto& entry, double t) { return static_cast<double>(entry.second) < t; });
+            result.push_back(it == view.end() ? m_max : it->first);
+        }
+    }
+    return result;
+}
+
+double QuantileSketch::quantile(double p) const {
+    return quantiles({p}).front();
+}
+
+double QuantileSketch::median() const {
+    return quantile(0.5);
+}
+
+double QuantileSketch::rank(double value) const {
+    if (m_count == 0) {
+        throw std::invalid_argument("Cannot find rank in empty list");
+    }
+    const auto view = sorted_view();
+    const auto it = std::upper_bound(view.begin(), view.end(), value,
+        [](double v, const auto& entry) { return v < entry.first; });
+    const std::uint64_t below = it == view.begin() ? 0 : std::prev(it)->second;
+    return static_cast<double>(below) / static_cast<double>(view.back().second);
+}
+
+// Layout: "IKLL", version u8, k u16, count u64, min f64, max f64, random u64, levels u8,
+// then per level: size u32 followed by the values as f64
+std::vector<std::uint8_t> QuantileSketch::serialize() const {
+    std::vector<std::uint8_t> out(std::begin(MAGIC), std::end(MAGIC));
+    out.reserve(4 + 1 + 2 + 8 * 4 + 1 + 4 * m_levels.size() + 8 * retained());
+    out.push_back(FORMAT_VERSION);
+    put_u64(out, m_k, 2);
+    put_u64(out, m_count, 8);
+    put_double(out, m_min);
+    put_double(out, m_max);
+    put_u64(out, m_random, 8);
+    put_u64(out, m_levels.size(), 1);
+    for (const auto& level : m_levels) {
+        put_u64(out, level.size(), 4);
+        for (const double v : level) put_double(out, v);
+    }
+    return out;
+}
+
+QuantileSketch QuantileSketch::deserialize(std::span<const std::uint8_t> bytes) {
+    Reader in(bytes);
+    for (const std::uint8_t m : MAGIC)
+        if (in.u64(1) != m)
+            throw std::invalid_argument("Not a quantile sketch encoding");
+    if (in.u64(1) != FORMAT_VERSION)
+        throw std::invalid_argument("Unsupported quantile sketch version");
+
+    QuantileSketch sketch(static_cast<size_t>(in.u64(2)));
+    sketch.m_count = in.u64(8);
+    sketch.m_min = in.f64();
+    sketch.m_max = in.f64();
+    sketch.m_random = in.u64(8);
+    const size_t levels = static_cast<size_t>(in.u64(1));
+    if (levels == 0 || levels > MAX_LEVELS || sketch.m_random == 0)
+        throw std::invalid_argument("Corrupt quantile sketch encoding");
+
+    while (sketch.m_levels.size() < levels) sketch.add_level();
+    std::uint64_t weight = 0;
+    for (size_t h = 0; h < levels; ++h) {
+        const size_t size = static_cast<size_t>(in.u64(4));
+        if (size > bytes.size() / 8)
+            throw std::invalid_argument("Truncated quantile sketch encoding");
+        sketch.m_levels[h].resize(size);
+        for (double& v : sketch.m_levels[h]) v = in.f64();
+        sketch.m_retained += size;
+        weight += static_cast<std::uint64_t>(size) << h;
+    }
+    if (!in.done() || weight != sketch.m_count)
+        throw std::invalid_argument("Corrupt quantile sketch encoding");
+    return sketch;
+}
+
+QuantileSketch operator+(QuantileSketch lhs, const QuantileSketch& rhs) {
+    lhs.merge(rhs);
+    return lhs;
+}
+
+} // namespace imeth::Statistics
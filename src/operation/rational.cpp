@@ -0,0 +1,246 @@
+#include "../include/imeth/operation/rational.hpp"
+#include "../detail/parallel.hpp"
+#include <algorithm>
+#include <bit>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace imeth {
+
+namespace {
+
+// Element-wise batches below this size stay on the calling thread
+constexpr size_t PARALLEL_GRAIN = size_t{1} << 14;
+// sum() adds fixed blocks, so the representation it reduces from does not depend on threads
+constexpr size_t SUM_BLOCK = size_t{1} << 12;
+
+template <typename T>
+struct Unsigned {
+    using type = std::uint64_t;
+};
+#if defined(__SIZEOF_INT128__)
+template <>
+struct Unsigned<__int128> {
+    using type = unsigned __int128;
+};
+#endif
+
+template <typename U>
+int trailing_zeros(const U x) {
+    if constexpr (sizeof(U) <= sizeof(std::uint64_t)) {
+        return std::countr_zero(static_cast<std::uint64_t>(x));
+    } else {
+        const auto low = static_cast<std::uint64_t>(x);
+        return low != 0 ? std::countr_zero(low) : 64 + std::countr_zero(static_cast<std::uint64_t>(x >> 64));
+    }
+}
+
+// Stein's binary GCD, as in NumberTheory::gcd but also for 128-bit terms
+template <typename U>
+U binary_gcd(U a, U b) {
+    if (a == 0) return b;
+    if (b == 0) return a;
+    const int shift = trailing_zeros(a | b);
+    a >>= trailing_zeros(a);
+    do {
+        b >>= trailing_zeros(b);
+        if (a > b) std::swap(a, b);
+        b -= a;
+    } while (b != 0);
+    return a << shift;
+}
+
+template <typename T>
+typename Unsigned<T>::type magnitude(const T x) {
+    using U = typename Unsigned<T>::type;
+    return x < 0 ? U{0} - static_cast<U>(x) : static_cast<U>(x);
+}
+
+// gcd(|a|, |b|); 2^63 (or 2^127) only arises from two most-negative terms and comes back as
+// that value, which still divides them exactly
+template <typename T>
+T gcd(const T a, const T b) {
+    return static_cast<T>(binary_gcd(magnitude(a), magnitude(b)));
+}
+
+template <typename T>
+[[noreturn]] void throw_overflow() {
+    throw std::overflow_error("Fraction does not fit in " + std::to_string(sizeof(T) * 8) + "-bit terms");
+}
+
+// Lowest terms in place
+template <typename T>
+void reduce_terms(T& num, T& den) {
+    const T g = gcd(num, den);
+    if (g != 1) {
+        num /= g;
+        den /= g;
+    }
+}
+
+} // namespace
+
+template <typename T>
+Rational<T> Rational<T>::reduced() const {
+    Rational r = *this;
+    reduce_terms(r.m_num, r.m_den);
+    return r;
+}
+
+template <typename T>
+Rational<T> Rational<T>::reciprocal() const {
+    if (m_num == 0) throw std::invalid_argument("Cannot divide by zero");
+    return Rational(m_den, m_num);
+}
+
+template <typename T>
+void Rational<T>::normalize_sign() {
+    T num, den;
+    if (detail_rational::sub_overflow(T{0}, m_num, num) || detail_rational::sub_overflow(T{0}, m_den, den)) {
+        // One term is the most negative value; a common factor may bring it into range
+        reduce_terms(m_num, m_den);
+        if (m_den > 0) return;  // both terms were the most negative value
+        if (detail_rational::sub_overflow(T{0}, m_num, num) || detail_rational::sub_overflow(T{0}, m_den, den))
+            throw_overflow<T>();
+    }
+    m_num = num;
+    m_den = den;
+}
+
+// a/b +- c/d with g = gcd(b, d): the numerator a(d/g) +- c(b/g) only shares factors with g,
+// so one more GCD against g leaves the result in lowest terms (Knuth, TAOCP 4.5.1)
+template <typename T>
+Rational<T> Rational<T>::add_reduced(Rational x, Rational y, const bool subtract) {
+    reduce_terms(x.m_num, x.m_den);
+    reduce_terms(y.m_num, y.m_den);
+    const T g = gcd(x.m_den, y.m_den);
+    T left, right, num, den;
+#if defined(__SIZEOF_INT128__)
+    if constexpr (sizeof(T) == sizeof(std::int64_t)) {
+        // The numerator can need 65 bits before the last cancellation; keep it in 128 so the
+        // sum only throws when the result itself does not fit
+        const __int128 l = static_cast<__int128>(x.m_num) * (y.m_den / g);
+        const __int128 r = static_cast<__int128>(y.m_num) * (x.m_den / g);
+        const __int128 wide = subtract ? l - r : l + r;
+        const auto h = static_cast<T>(binary_gcd(magnitude(wide), magnitude(static_cast<__int128>(g))));
+        const __int128 n = wide / h;
+        if (n < INT64_MIN || n > INT64_MAX || detail_rational::mul_overflow(x.m_den / g, y.m_den / h, den))
+            throw_overflow<T>();
+        return Rational(static_cast<T>(n), den, Unchecked{});
+    }
+#endif
+    if (detail_rational::mul_overflow(x.m_num, y.m_den / g, left) ||
+        detail_rational::mul_overflow(y.m_num, x.m_den / g, right) ||
+        (subtract ? detail_rational::sub_overflow(left, right, num) : detail_rational::add_overflow(left, right, num)))
+        throw_overflow<T>();
+    const T h = gcd(num, g);
+    if (detail_rational::mul_overflow(x.m_den / g, y.m_den / h, den)) throw_overflow<T>();
+    return Rational(num / h, den, Unchecked{});
+}
+
+// Cross-cancelling a with d and c with b keeps the product of reduced inputs reduced
+template <typename T>
+Rational<T> Rational<T>::multiply_reduced(Rational x, Rational y) {
+    reduce_terms(x.m_num, x.m_den);
+    reduce_terms(y.m_num, y.m_den);
+    const T g1 = gcd(x.m_num, y.m_den);
+    const T g2 = gcd(y.m_num, x.m_den);
+    T num, den;
+    if (detail_rational::mul_overflow(x.m_num / g1, y.m_num / g2, num) ||
+        detail_rational::mul_overflow(x.m_den / g2, y.m_den / g1, den))
+        throw_overflow<T>();
+    return Rational(num, den, Unchecked{});
+}
+
+// Same cross-cancelling with b's terms swapped. The sign moves onto the numerator before
+// multiplying, so a quotient of exactly -2^63 still fits.
+template <typename T>
+Rational<T> Rational<T>::divide_reduced(Rational x, Rational y) {
+    reduce_terms(x.m_num, x.m_den);
+    reduce_terms(y.m_num, y.m_den);
+    const T g1 = gcd(x.m_num, y.m_num);
+    const T g2 = gcd(y.m_den, x.m_den);
+    T flip = y.m_den / g2, divisor = y.m_num / g1, num, den;
+    if (divisor < 0) {
+        flip = -flip;
+        if (detail_rational::sub_overflow(T{0}, divisor, divisor)) throw_overflow<T>();
+    }
+    if (detail_rational::mul_overflow(x.m_num / g1, flip, num) ||
+        detail_rational::mul_overflow(x.m_den / g2, divisor, den))
+        throw_overflow<T>();
+    return Rational(num, den, Unchecked{});
+}
+
+// Compares continued fraction expansions: integer parts first, then the remainders by way of
+// their reciprocals. Every step stays within the terms, so nothing can overflow.
+template <typename T>
+std::strong_ordering Rational<T>::compare_exact(const Rational x, const Rational y) {
+    T a = x.m_num, b = x.m_den, c = y.m_num, d = y.m_den;
+    while (true) {
+        T q1 = a / b, r1 = a % b;
+        if (r1 < 0) {
+            r1 += b;
+            --q1;
+        }
+        T q2 = c / d, r2 = c % d;
+        if (r2 < 0) {
+            r2 += d;
+            --q2;
+        }
+        if (q1 != q2) return q1 <=> q2;
+        if (r1 == 0 || r2 == 0) return (r1 != 0) <=> (r2 != 0);
+        // r1/b vs r2/d orders the same way as d/r2 vs b/r1
+        const T left_den = b;
+        a = d, b = r2, c = left_den, d = r1;
+    }
+}
+
+template <typename T>
+void Rational<T>::add(std::span<const Rational> a, std::span<const Rational> b, std::span<Rational> out) {
+    if (a.size() != b.size() || a.size() != out.size())
+        throw std::invalid_argument("Fraction arrays must have the same size");
+    detail::parallel_for(0, out.size(), PARALLEL_GRAIN, [&](size_t lo, size_t hi) {
+        for (size_t i = lo; i < hi; ++i) out[i] = a[i] + b[i];
+    });
+}
+
+template <typename T>
+void Rational<T>::multiply(std::span<const Rational> a, std::span<const Rational> b, std::span<Rational> out) {
+    if (a.size() != b.size() || a.size() != out.size())
+        throw std::invalid_argument("Fraction arrays must have the same size");
+    detail::parallel_for(0, out.size(), PARALLEL_GRAIN, [&](size_t lo, size_t hi) {
+        for (size_t i = lo; i < hi; ++i) out[i] = a[i] * b[i];
+    });
+}
+
+template <typename T>
+Rational<T> Rational<T>::sum(std::span<const Rational> values) {
+    const size_t blocks = (values.size() + SUM_BLOCK - 1) / SUM_BLOCK;
+    std::vector<Rational> partial(blocks);
+    detail::parallel_for(0, blocks, PARALLEL_GRAIN / SUM_BLOCK, [&](size_t b0, size_t b1) {
+        for (size_t b = b0; b < b1; ++b) {
+            const size_t end = std::min(values.size(), (b + 1) * SUM_BLOCK);
+            Rational s;
+            for (size_t i = b * SUM_BLOCK; i < end; ++i) s += values[i];
+            partial[b] = s;
+        }
+    });
+    Rational total;
+    for (const Rational& p : partial) total += p;
+    return total.reduced();
+}
+
+template <typename T>
+void Rational<T>::reduce(std::span<Rational> values) {
+    detail::parallel_for(0, values.size(), PARALLEL_GRAIN, [&](size_t lo, size_t hi) {
+        for (size_t i = lo; i < hi; ++i) reduce_terms(values[i].m_num, values[i].m_den);
+    });
+}
+
+template class Rational<std::int64_t>;
+#if defined(__SIZEOF_INT128__)
+template class Rational<__int128>;
+#endif
+
+} // namespace imeth
@@ -0,0 +1,305 @@
+#include "../include/imeth/operation/rolling_window.hpp"
+#include "../detail/reduce.hpp"
+#include <algorithm>
+#include <cmath>
+#include <iterator>
+#include <stdexcept>
+
+namespace imeth::Statistics {
+
+namespace {
+
+// Full windows between exact recomputations of sum, mean and M2 from the buffer
+constexpr std::uint64_t RESYNC_WINDOWS = 64;
+
+void check_batch(std::span<const double> values, const size_t window) {
+    if (window == 0) {
+        throw std::invalid_argument("Window size must be positive");
+    }
+    for (const double v : values)
+        if (std::isnan(v)) throw std::invalid_argument("Cannot compute rolling statistics of NaN");
+}
+
+// Slides a Moments accumulator over the array, resynchronizing from the array itself
+template <typename Stat>
+std::vector<double> rolling_moments(std::span<const double> values, const size_t window, Stat stat) {
+    check_batch(values, window);
+    std::vector<double> result;
+    if (values.size() < window) return result;
+    result.resize(values.size() - window + 1);
+
+    detail_rolling::Moments moments;
+    for (size_t i = 0; i < window; ++i) moments.add(values[i]);
+    result[0] = stat(moments);
+    for (size_t i = window; i < values.size(); ++i) {
+        const size_t first = i - window + 1;
+        if (first % (RESYNC_WINDOWS * window) == 0)
+            moments.resync(values.data() + first, window);
+        else
+            moments.replace(values[i - window], values[i]);
+        result[first] = stat(moments);
+    }
+    return result;
+}
+
+// van Herk / Gil-Werman: cut the array into blocks of `window` values and take running
+// extremes forwards (prefix) and backwards (suffix) inside each block. A window starting at i
+// spans the tail of one block and the head of the next, so its extreme is
+// pick(suffix[i], prefix[i + window - 1]). The suffixes are written straight into the result
+// and the prefixes are a running value, so no scratch arrays are needed.
+template <typename Pick>
+std::vector<double> rolling_extreme(std::span<const double> values, const size_t window, Pick pick) {
+    check_batch(values, window);
+    std::vector<double> result;
+    const size_t n = values.size();
+    if (n < window) return result;
+    const size_t m = n - window + 1;
+    result.resize(m);
+
+    for (size_t lo = 0; lo < m; lo += window) {
+        const size_t hi = std::min(n, lo + window);
+        double suffix = values[hi - 1];
+        for (size_t i = hi - 1; i >= m; --i) suffix = pick(suffix, values[i]);
+        for (size_t i = std::min(hi, m); i-- > lo;) result[i] = suffix = pick(suffix, values[i]);
+    }
+    // prefix runs over values[window - 1, n); offset is that index's position in its block
+    double prefix = values[window - 1];
+    size_t offset = window - 1;
+    for (size_t i = 0; i < m; ++i) {
+        const double v = values[i + window - 1];
+        prefix = offset == 0 ? v : pick(prefix, v);
+        offset = offset + 1 == window ? 0 : offset + 1;
+        result[i] = pick(result[i], prefix);
+    }
+    return result;
+}
+
+} // namespace
+
+namespace detail_rolling {
+
+void Moments::add(const double value) {
+    ++m_count;
+    const double delta = value - m_mean;
+    m_mean += delta / static_cast<double>(m_count);
+    m_m2 += delta * (value - m_mean);
+    detail::reduce::neumaier_add(m_sum, m_compensation, value);
+}
+
+// Swapping old for value moves the mean by (value - old) / n and M2 by
+// (value - old) * (value - mean' + old - mean)
+void Moments::replace(const double old, const double value) {
+    const double previous_mean = m_mean;
+    m_mean += (value - old) / static_cast<double>(m_count);
+    m_m2 += (value - old) * (value - m_mean + old - previous_mean);
+    if (m_m2 < 0.0) m_m2 = 0.0;
+    detail::reduce::neumaier_add(m_sum, m_compensation, value);
+    detail::reduce::neumaier_add(m_sum, m_compensation, -old);
+}
+
+// Exact two-pass recomputation; the order of the values does not matter
+void Moments::resync(const double* values, const size_t n) {
+    m_count = n;
+    m_sum = detail::reduce::sum(values, n, detail::reduce::Method::Compensated);
+    m_compensation = 0.0;
+    m_mean = m_sum / static_cast<double>(n);
+    double m2 = 0.0;
+    for (size_t i = 0; i < n; ++i) m2 += (values[i] - m_mean) * (values[i] - m_mean);
+    m_m2 = m2;
+}
+
+ExtremeQueue::ExtremeQueue(const size_t window, const bool largest)
+    : m_window(window), m_largest(largest), m_indices(window + 1), m_values(window + 1) {}
+
+// Candidates that can never be the answer again (not better than the new value) leave from
+// the back, expired ones from the front, so the front is always the extreme of the window
+void ExtremeQueue::push(const std::uint64_t index, const double value) {
+    const size_t slots = m_values.size();
+    while (m_size != 0) {
+        const size_t back = (m_head + m_size - 1) % slots;
+        if (m_largest ? m_values[back] > value : m_values[back] < value) break;
+        --m_size;
+    }
+    const size_t tail = (m_head + m_size) % slots;
+    m_indices[tail] = index;
+    m_values[tail] = value;
+    ++m_size;
+    while (m_indices[m_head] + m_window <= index) {
+        m_head = m_head + 1 == slots ? 0 : m_head + 1;
+        --m_size;
+    }
+}
+
+// Values at or above the smallest of m_high belong there, everything else in m_low
+void MedianHalves::insert(const double value) {
+    if (!m_high.empty() && value >= *m_high.begin())
+        m_high.insert(value);
+    else
+        m_low.insert(value);
+    rebalance();
+}
+
+void MedianHalves::replace(const double old, const double value) {
+    // Every value up to the largest of m_low is held there, so that is where old lives
+    auto node = old <= *m_low.rbegin() ? m_low.extract(m_low.find(old)) : m_high.extract(m_high.find(old));
+    node.value() = value;
+    if (!m_high.empty() && value >= *m_high.begin())
+        m_high.insert(std::move(node));
+    else
+        m_low.insert(std::move(node));
+    rebalance();
+}
+
+void MedianHalves::rebalance() {
+    if (m_low.size() > m_high.size() + 1)
+        m_high.insert(m_high.begin(), m_low.extract(std::prev(m_low.end())));
+    else if (m_high.size() > m_low.size())
+        m_low.insert(m_low.end(), m_high.extract(m_high.begin()));
+}
+
+double MedianHalves::median() const {
+    if (m_low.size() > m_high.size()) return *m_low.rbegin();
+    return (*m_low.rbegin() + *m_high.begin()) / 2.0;
+}
+
+} // namespace detail_rolling
+
+RollingWindow::RollingWindow(const size_t window, const bool with_median)
+    : m_window(window), m_with_median(with_median), m_min(window, false), m_max(window, true) {
+    if (window == 0) {
+        throw std::invalid_argument("Window size must be positive");
+    }
+    m_ring.resize(window);
+}
+
+void RollingWindow::push(const double value) {
+    if (std::isnan(value)) {
+        throw std::invalid_argument("Cannot push NaN into a rolling window");
+    }
+    const std::uint64_t index = m_pushed++;
+    m_min.push(index, value);
+    m_max.push(index, value);
+
+    if (m_moments.count() < m_window) {
+        m_moments.add(value);
+        if (m_with_median) m_median.insert(value);
+    } else {
+        const double old = m_ring[m_next];
+        m_moments.replace(old, value);
+        if (m_with_median) m_median.replace(old, value);
+    }
+    m_ring[m_next] = value;
+    m_next = m_next + 1 == m_window ? 0 : m_next + 1;
+
+    if (m_pushed % (RESYNC_WINDOWS * m_window) == 0) m_moments.resync(m_ring.data(), m_window);
+}
+
+void RollingWindow::push(std::span<const double> values) {
+    for (const double v : values) push(v);
+}
+
+void RollingWindow::reset() {
+    *this = RollingWindow(m_window, m_with_median);
+}
+
+size_t RollingWindow::window() const { return m_window; }
+size_t RollingWindow::count() const { return m_moments.count(); }
+bool RollingWindow::empty() const { return m_moments.count() == 0; }
+bool RollingWindow::full() const { return m_moments.count() == m_window; }
+
+double RollingWindow::sum() const { return m_moments.sum(); }
+
+double RollingWindow::average() const {
+    if (empty()) {
+        throw std::invalid_argument("Cannot find average of empty list");
+    }
+    return m_moments.mean();
+}
+
+double RollingWindow::variance() const {
+    if (empty()) {
+        throw std::invalid_argument("Cannot find variance of empty list");
+    }
+    return m_moments.m2() / static_cast<double>(m_moments.count());
+}
+
+double RollingWindow::sample_variance() const {
+    if (m_moments.count() < 2) {
+        throw std::invalid_argument("Sample variance needs at least two values");
+    }
+    return m_moments.m2() / static_cast<double>(m_moments.count() - 1);
+}
+
+double RollingWindow::standard_deviation() const {
+    return std::sqrt(variance());
+}
+
+double RollingWindow::minimum() const {
+    if (empty()) {
+        throw std::invalid_argument("Cannot find minimum of empty list");
+    }
+    return m_min.front();
+}
+
+double RollingWindow::maximum() const {
+    if (empty()) {
+        throw std::invalid_argument("Cannot find maximum of empty list");
+    }
+    return m_max.front();
+}
+
+double RollingWindow::median() const {
+    if (!m_with_median) {
+        throw std::logic_error("RollingWindow was constructed without median tracking");
+    }
+    if (empty()) {
+        throw std::invalid_argument("Cannot find median of empty list");
+    }
+    return m_median.median();
+}
+
+std::vector<double> rolling_sum(std::span<const double> values, const size_t window) {
+    return rolling_moments(values, window, [](const detail_rolling::Moments& m) { return m.sum(); });
+}
+
+std::vector<double> rolling_average(std::span<const double> values, const size_t window) {
+    return rolling_moments(values, window, [](const detail_rolling::Moments& m) { return m.mean(); });
+}
+
+std::vector<double> rolling_variance(std::span<const double> values, const size_t window) {
+    return rolling_moments(values, window, [](const detail_rolling::Moments& m) {
+        return m.m2() / static_cast<double>(m.count());
+    });
+}
+
+std::vector<double> rolling_standard_deviation(std::span<const double> values, const size_t window) {
+    return rolling_moments(values, window, [](const detail_rolling::Moments& m) {
+        return std::sqrt(m.m2() / static_cast<double>(m.count()));
+    });
+}
+
+std::vector<double> rolling_minimum(std::span<const double> values, const size_t window) {
+    return rolling_extreme(values, window, [](double a, double b) { return b < a ? b : a; });
+}
+
+std::vector<double> rolling_maximum(std::span<const double> values, const size_t window) {
+    return rolling_extreme(values, window, [](double a, double b) { return b > a ? b : a; });
+}
+
+std::vector<double> rolling_median(std::span<const double> values, const size_t window) {
+    check_batch(values, window);
+    std::vector<double> result;
+    if (values.size() < window) return result;
+    result.resize(values.size() - window + 1);
+
+    detail_rolling::MedianHalves halves;
+    for (size_t i = 0; i < window; ++i) halves.insert(values[i]);
+    result[0] = halves.median();
+    for (size_t i = window; i < values.size(); ++i) {
+        halves.replace(values[i - window], values[i]);
+        result[i - window + 1] = halves.median();
+    }
+    return result;
+}
+
+} // namespace imeth::Statistics
@@ -0,0 +1,51 @@
+#include "../include/imeth/operation/sequence_view.hpp"
+#include "../detail/reduce.hpp"
+#include <stdexcept>
+
+namespace imeth {
+
+namespace {
+
+// Independent recurrences per chunk: lane k starts at term k and jumps LANES terms per
+// step, so there is no loop-carried chain longer than one operation
+constexpr size_t LANES = 8;
+
+void check_range(unsigned long long offset, size_t count, unsigned long long terms) {
+    if (offset > terms || count > terms - offset) {
+        throw std::out_of_range("Sequence has fewer terms than requested");
+    }
+}
+
+// Blocks of the output are filled on separate threads; each starts its lanes with term()
+template <typename Sequence, typename Advance>
+void fill_lanes(const Sequence& sequence, unsigned long long offset, std::span<unsigned long long> out,
+                Advance&& advance) {
+    detail::reduce::for_each_block(out.size(), [&](size_t, size_t lo, size_t hi) {
+        unsigned long long lane[LANES];
+        for (size_t k = 0; k < LANES; ++k) lane[k] = sequence.term(offset + lo + k);
+        size_t j = lo;
+        for (; j + LANES <= hi; j += LANES) {
+            for (size_t k = 0; k < LANES; ++k) {
+                out[j + k] = lane[k];
+                lane[k] = advance(lane[k]);
+            }
+        }
+        for (size_t k = 0; j + k < hi; ++k) out[j + k] = lane[k];
+    });
+}
+
+} // namespace
+
+void ArithmeticSequence::fill(unsigned long long offset, std::span<unsigned long long> out) const {
+    check_range(offset, out.size(), m_terms);
+    const unsigned long long step = m_diff * LANES;
+    fill_lanes(*this, offset, out, [step](unsigned long long v) { return v + step; });
+}
+
+void GeometricSequence::fill(unsigned long long offset, std::span<unsigned long long> out) const {
+    check_range(offset, out.size(), m_terms);
+    const unsigned long long step = GeometricSequence(1, m_ratio, LANES).term(LANES);
+    fill_lanes(*this, offset, out, [step](unsigned long long v) { return v * step; });
+}
+
+} // namespace imeth
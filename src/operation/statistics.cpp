@@ -0,0 +1,334 @@
+#include "../include/imeth/operation/statistics.hpp"
+#include "../include/imeth/operation/arithmetic.hpp"
+#include "../detail/reduce.hpp"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+#include <vector>
+
+namespace imeth::Statistics {
+
+namespace {
+
+// Values per chunk of a column push: a chunk stays in L1 across its passes
+constexpr size_t CHUNK = 1024;
+// Pairs per chunk of a paired column push
+constexpr size_t CO_CHUNK = 1024;
+
+} // namespace
+
+// Once an infinity is pushed the mean is that infinity, as sum / count would be (NaN for both
+// signs); Welford's update would subtract it from itself and give NaN
+void RunningStats::push(const double value) {
+    ++m_count;
+    if (!std::isfinite(value) || !std::isfinite(m_mean)) [[unlikely]] {
+        m_mean += value;
+        m_m2 = std::numeric_limits<double>::quiet_NaN();
+    } else {
+        const double delta = value - m_mean;
+        m_mean += delta / static_cast<double>(m_count);
+        m_m2 += delta * (value - m_mean);
+    }
+    detail::reduce::neumaier_add(m_sum, m_sum_compensation, value);
+    if (value < m_min) m_min = value;
+    if (value > m_max) m_max = value;
+}
+
+// Each chunk is summarized exactly (compensated sum, M2 around its own mean) by the vector
+// kernels and folded in with merge(), instead of one division per value. A chunk whose sum is
+// not finite (an infinity, a NaN, or an overflowing sum) has no usable shift, since x - inf
+// is NaN, and is pushed value by value instead.
+void RunningStats::push(std::span<const double> values) {
+    for (size_t c0 = 0; c0 < values.size(); c0 += CHUNK) {
+        const size_t len = std::min(CHUNK, values.size() - c0);
+        const double count = static_cast<double>(len);
+        const double* x = values.data() + c0;
+        const detail::simd::CompensatedSum total = detail::simd::sum_compensated(x, len);
+        if (!std::isfinite(total.sum)) [[unlikely]] {
+            for (size_t i = 0; i < len; ++i) push(x[i]);
+            continue;
+        }
+        const double shift = (total.sum + total.error) / count;
+        const detail::simd::CoMoments m = detail::simd::co_moments(x, x, len, shift, shift);
+
+        RunningStats chunk;
+        chunk.m_count = len;
+        chunk.m_mean = shift + m.dx / count;
+        chunk.m_m2 = std::max(0.0, m.dxx - m.dx * m.dx / count);
+        chunk.m_sum = total.sum;
+        chunk.m_sum_compensation = total.error;
+        chunk.m_min = detail::simd::min(x, len);
+        chunk.m_max = detail::simd::max(x, len);
+        merge(chunk);
+    }
+}
+
+void RunningStats::merge(const RunningStats& other) {
+    if (other.m_count == 0) return;
+    if (m_count == 0) {
+        *this = other;
+        return;
+    }
+
+    // Chan et al.: combine the two (count, mean, M2) triples in O(1)
+    if (!std::isfinite(m_mean) || !std::isfinite(other.m_mean)) [[unlikely]] {
+        m_mean += other.m_mean;
+        m_m2 = std::numeric_limits<double>::quiet_NaN();
+    } else {
+        const double na = static_cast<double>(m_count);
+        const double nb = static_cast<double>(other.m_count);
+        const double n = na + nb;
+        const double delta = other.m_mean - m_mean;
+        m_mean += delta * nb / n;
+        m_m2 += other.m_m2 + delta * delta * na * nb / n;
+    }
+    m_count += other.m_count;
+
+    detail::reduce::neumaier_add(m_sum, m_sum_compensation, other.m_sum);
+    m_sum_compensation += other.m_sum_compensation;
+    if (other.m_min < m_min) m_min = other.m_min;
+    if (other.m_max > m_max) m_max = other.m_max;
+}
+
+RunningStats& RunningStats::operator+=(const RunningStats& other) {
+    merge(other);
+    return *this;
+}
+
+void RunningStats::reset() {
+    *this = RunningStats{};
+}
+
+size_t RunningStats::count() const { return m_count; }
+bool RunningStats::empty() const { return m_count == 0; }
+// An infinite sum leaves a NaN compensation behind (inf - inf), so it is returned alone
+double RunningStats::sum() const { return std::isfinite(m_sum) ? m_sum + m_sum_compensation : m_sum; }
+
+double RunningStats::average() const {
+    if (m_count == 0) {
+        throw std::invalid_argument("Cannot find average of empty list");
+    }
+    return m_mean;
+}
+
+double RunningStats::variance() const {
+    if (m_count == 0) {
+        throw std::invalid_argument("Cannot find variance of empty list");
+    }
+    return m_m2 / static_cast<double>(m_count);
+}
+
+double RunningStats::sample_variance() const {
+    if (m_count < 2) {
+        throw std::invalid_argument("Sample variance needs at least two values");
+    }
+    return m_m2 / static_cast<double>(m_count - 1);
+}
+
+double RunningStats::standard_deviation() const {
+    return Arithmetic::square_root(variance());
+}
+
+double RunningStats::minimum() const {
+    if (m_count == 0) {
+        throw std::invalid_argument("Cannot find minimum of empty list");
+    }
+    return m_min;
+}
+
+double RunningStats::maximum() const {
+    if (m_count == 0) {
+        throw std::invalid_argument("Cannot find maximum of empty list");
+    }
+    return m_max;
+}
+
+double RunningStats::range() const {
+    return maximum() - minimum();
+}
+
+RunningStats operator+(RunningStats lhs, const RunningStats& rhs) {
+    lhs.merge(rhs);
+    return lhs;
+}
+
+void RunningCovariance::push(const double x, const double y) {
+    ++m_count;
+    const double n = static_cast<double>(m_count);
+    const double dx = x - m_mean_x;
+    const double dy = y - m_mean_y;
+    m_mean_x += dx / n;
+    m_mean_y += dy / n;
+    m_m2_x += dx * (x - m_mean_x);
+    m_m2_y += dy * (y - m_mean_y);
+    m_c += dx * (y - m_mean_y);
+}
+
+// Each chunk is summed once for a shift near its means, then once more by the co-moment kernel
+// for the shifted sums and products; the leftover sum of the shifted values corrects the shift
+// exactly. Chunks merge into per-block states, and blocks merge in index order, so the result
+// does not depend on the thread count.
+void RunningCovariance::push(std::span<const double> xs, std::span<const double> ys) {
+    if (xs.size() != ys.size()) {
+        throw std::invalid_argument("Paired columns must have the same length");
+    }
+    const size_t n = xs.size();
+    if (n == 0) return;
+
+    std::vector<RunningCovariance> partial((n + detail::reduce::BLOCK - 1) / detail::reduce::BLOCK);
+    detail::reduce::for_each_block(n, [&](size_t b, size_t lo, size_t hi) {
+        RunningCovariance block;
+        for (size_t c0 = lo; c0 < hi; c0 += CO_CHUNK) {
+            const size_t len = std::min(CO_CHUNK, hi - c0);
+            const double count = static_cast<double>(len);
+            const double* x = xs.data() + c0;
+            const double* y = ys.data() + c0;
+            const double shift_x = detail::simd::sum(x, len) / count;
+            const double shift_y = detail::simd::sum(y, len) / count;
+            if (!std::isfinite(shift_x) || !std::isfinite(shift_y)) [[unlikely]] {
+                // No usable shift, as in RunningStats::push
+                for (size_t i = 0; i < len; ++i) block.push(x[i], y[i]);
+                continue;
+            }
+            const detail::simd::CoMoments m = detail::simd::co_moments(x, y, len, shift_x, shift_y);
+
+            RunningCovariance chunk;
+            chunk.m_count = len;
+            chunk.m_mean_x = shift_x + m.dx / count;
+            chunk.m_mean_y = shift_y + m.dy / count;
+            chunk.m_m2_x = std::max(0.0, m.dxx - m.dx * m.dx / count);
+            chunk.m_m2_y = std::max(0.0, m.dyy - m.dy * m.dy / count);
+            chunk.m_c = m.dxy - m.dx * m.dy / count;
+            block.merge(chunk);
+        }
+        partial[b] = block;
+    });
+    for (const RunningCovariance& p : partial) merge(p);
+}
+
+void RunningCovariance::merge(const RunningCovariance& other) {
+    if (other.m_count == 0) return;
+    if (m_count == 0) {
+        *this = other;
+        return;
+    }
+
+    // Chan et al. for both means, both M2 and the co-moment
+    const double na = static_cast<double>(m_count);
+    const double nb = static_cast<double>(other.m_count);
+    const double n = na + nb;
+    const double dx = other.m_mean_x - m_mean_x;
+    const double dy = other.m_mean_y - m_mean_y;
+    const double weight = na * nb / n;
+    m_mean_x += dx * nb / n;
+    m_mean_y += dy * nb / n;
+    m_m2_x += other.m_m2_x + dx * dx * weight;
+    m_m2_y += other.m_m2_y + dy * dy * weight;
+    m_c += other.m_c + dx * dy * weight;
+    m_count += other.m_count;
+}
+
+RunningCovariance& RunningCovariance::operator+=(const RunningCovariance& other) {
+    merge(other);
+    return *this;
+}
+
+void RunningCovariance::reset() {
+    *this = RunningCovariance{};
+}
+
+size_t RunningCovariance::count() const { return m_count; }
+bool RunningCovariance::empty() const { return m_count == 0; }
+
+double RunningCovariance::mean_x() const {
+    if (m_count == 0) {
+        throw std::invalid_argument("Cannot find average of empty list");
+    }
+    return m_mean_x;
+}
+
+double RunningCovariance::mean_y() const {
+    if (m_count == 0) {
+        throw std::invalid_argument("Cannot find average of empty list");
+    }
+    return m_mean_y;
+}
+
+double RunningCovariance::variance_x() const {
+    if (m_count == 0) {
+        throw std::invalid_argument("Cannot find variance of empty list");
+    }
+    return m_m2_x / static_cast<double>(m_count);
+}
+
+double RunningCovariance::variance_y() const {
+    if (m_count == 0) {
+        throw std::invalid_argument("Cannot find variance of empty list");
+    }
+    return m_m2_y / static_cast<double>(m_count);
+}
+
+double RunningCovariance::covariance() const {
+    if (m_count == 0) {
+        throw std::invalid_argument("Cannot find covariance of empty list");
+    }
+    return m_c / static_cast<double>(m_count);
+}
+
+double RunningCovariance::sample_covariance() const {
+    if (m_count < 2) {
+        throw std::invalid_argument("Sample covariance needs at least two values");
+    }
+    return m_c / static_cast<double>(m_count - 1);
+}
+
+double RunningCovariance::correlation() const {
+    if (m_count == 0) {
+        throw std::invalid_argument("Cannot find correlation of empty list");
+    }
+    if (m_m2_x == 0.0 || m_m2_y == 0.0) {
+        throw std::invalid_argument("Correlation is undefined for a constant column");
+    }
+    // Two square roots rather than one of the product, which can overflow
+    const double r = m_c / std::sqrt(m_m2_x) / std::sqrt(m_m2_y);
+    return std::clamp(r, -1.0, 1.0);
+}
+
+LinearFit RunningCovariance::fit() const {
+    if (m_count == 0) {
+        throw std::invalid_argument("Cannot fit a line to an empty list");
+    }
+    if (m_m2_x == 0.0) {
+        throw std::invalid_argument("Regression needs at least two distinct x values");
+    }
+    const double slope = m_c / m_m2_x;
+    // A constant y is fitted exactly by the horizontal line
+    const double r_squared = m_m2_y == 0.0 ? 1.0 : std::min(1.0, (m_c / m_m2_x) * (m_c / m_m2_y));
+    return {slope, m_mean_y - slope * m_mean_x, r_squared};
+}
+
+RunningCovariance operator+(RunningCovariance lhs, const RunningCovariance& rhs) {
+    lhs.merge(rhs);
+    return lhs;
+}
+
+double covariance(std::span<const double> xs, std::span<const double> ys) {
+    RunningCovariance accumulator;
+    accumulator.push(xs, ys);
+    return accumulator.covariance();
+}
+
+double correlation(std::span<const double> xs, std::span<const double> ys) {
+    RunningCovariance accumulator;
+    accumulator.push(xs, ys);
+    return accumulator.correlation();
+}
+
+LinearFit linear_regression(std::span<const double> xs, std::span<const double> ys) {
+    RunningCovariance accumulator;
+    accumulator.push(xs, ys);
+    return accumulator.fit();
+}
+
+} // namespace imeth::Statistics
@@ -1,9 +1,23 @@
 #include <iostream>
+#include <limits>
 #include <imeth/geometry/2D.hpp>
 #include <imeth/geometry/3D.hpp>
+#include <imeth/geometry/spatial.hpp>
 #include <imeth/linear/algebra.hpp>
+#include <imeth/linear/decomposition.hpp>
+#include <imeth/linear/eigen.hpp>
 #include <imeth/linear/matrix.hpp>
+#include <imeth/linear/matrix_statistics.hpp>
+#include <imeth/linear/sparse_lu.hpp>
 #include <imeth/operation/arithmetic.hpp>
+#include <imeth/operation/expression.hpp>
+#include <imeth/operation/histogram.hpp>
+#include <imeth/operation/logarithm.hpp>
+#include <imeth/operation/number_theory.hpp>
+#include <imeth/operation/quantile_sketch.hpp>
+#include <imeth/operation/rational.hpp>
+#include <imeth/operation/rolling_window.hpp>
+#include <imeth/operation/statistics.hpp>
 
 int main() {
     imeth::Circle circle(5);
@@ -15,7 +29,14 @@ int main() {
     std::cout << "Circle area: " << circle.area() << ", perimeter: " << circle.perimeter() << "\n";
     std::cout << "Square area: " << square.area() << ", perimeter: " << square.perimeter() << "\n";
     std::cout << "Sphere area: " << sphere.area() << ", volume: " << sphere.volume() << "\n";
-    std::cout << "Cube area: " << cube.area() << ", volume: " << cube.volume() << "\n\n";
+    std::cout << "Cube area: " << cube.area() << ", volume: " << cube.volume() << "\n";
+
+    imeth::Matrix stations{{0, 0}, {10, 0}, {0, 10}, {10, 10}};
+    const imeth::Spatial::KDTree station_tree(stations);
+    const double home[] = {2, 3};
+    const auto closest = station_tree.nearest(home, 1);
+    std::cout << "Nearest station: " << closest[0].index << " at " << closest[0].distance
+              << ", stations 0 to 3: " << imeth::Spatial::pairwise_distances(stations)(0, 3) << "\n\n";
 
     std::cout << "=== LINEAR EQUATION TESTS ===\n";
 
@@ -39,7 +60,28 @@ int main() {
     std::cout << "Solution: ";
     for (size_t i = 0; i < x.size(); ++i)
         std::cout << x[i] << " ";
-    std::cout << "\n\n";
+    std::cout << "\n";
+
+    imeth::SparseLU sparse_lu(imeth::SparseMatrix::from_dense(A));
+    auto xs = sparse_lu.solve({11, 13});
+    std::cout << "Sparse LU solution: " << xs[0] << " " << xs[1] << "\n";
+
+    auto batch = imeth::Solver::batch_solve({{A, b}, {imeth::Matrix{{0, 1}, {1, 0}}, imeth::Vector{3, 4}}});
+    std::cout << "Batch solutions: " << batch[0][0] << " " << batch[0][1] << ", " << batch[1][0] << " " << batch[1][1] << "\n";
+
+    imeth::Matrix S{{2, 1}, {1, 3}};
+    auto eig = imeth::EigenSolver::lanczos(S, 2);
+    std::cout << "Eigenvalues: " << eig.values[0] << " " << eig.values[1] << "\n";
+    std::cout << "Dominant eigenvalue: " << imeth::EigenSolver::power_iteration(S).value << "\n";
+
+    imeth::Matrix D{{3, 1}, {1, 3}, {0, 2}};
+    auto svd = imeth::Decomposition::randomized_svd(D, 2);
+    std::cout << "Singular values: " << svd.singular_values[0] << " " << svd.singular_values[1] << "\n";
+
+    auto columns = imeth::MatrixStatistics::describe_columns(D);
+    auto column_medians = imeth::MatrixStatistics::column_median(D);
+    std::cout << "Column averages: " << columns.average[0] << " " << columns.average[1]
+              << ", medians: " << column_medians[0] << " " << column_medians[1] << "\n\n";
 
     std::cout << "=== ARITHMETIC TESTS ===\n";
 
@@ -59,10 +101,78 @@ int main() {
     std::cout << "Average: " << imeth::Arithmetic::average(grades) << "\n";
     std::cout << "Median: " << imeth::Arithmetic::median(grades) << "\n";
     std::cout << "Highest: " << imeth::Arithmetic::maximum(grades) << "\n";
-    std::cout << "Lowest: " << imeth::Arithmetic::minimum(grades) << "\n\n";
+    std::cout << "Lowest: " << imeth::Arithmetic::minimum(grades) << "\n";
+    std::cout << "Compensated sum: " << imeth::Arithmetic::sum(grades, imeth::Arithmetic::Summation::Neumaier) << "\n";
+    std::vector<double> roots(grades.size());
+    imeth::Arithmetic::cube_root(grades, roots);
+    std::cout << "Cube root of first grade: " << roots[0] << "\n";
+    const auto quartiles = imeth::Arithmetic::quantiles(grades, {0.25, 0.75});
+    std::cout << "Quartiles: " << quartiles[0] << " " << quartiles[1] << "\n";
+
+    const float readings[] = {1.5f, -2.0f, 4.25f};
+    std::cout << "Float sum: " << imeth::Arithmetic::sum(std::span<const float>(readings))
+              << ", max: " << imeth::Arithmetic::maximum(std::span<const float>(readings))
+              << ", range: " << imeth::Arithmetic::range(std::span<const float>(readings)) << "\n";
+
+    // NaN is skipped unless it is the first element, on every instruction set
+    std::vector<double> gaps(100);
+    for (size_t i = 0; i < gaps.size(); ++i) gaps[i] = static_cast<double>(i);
+    gaps[3] = gaps[50] = gaps[99] = std::numeric_limits<double>::quiet_NaN();
+    const std::vector<float> float_gaps(gaps.begin(), gaps.end());
+    std::cout << "With NaN: min " << imeth::Arithmetic::minimum(std::span<const double>(gaps))
+              << ", max " << imeth::Arithmetic::maximum(std::span<const double>(gaps))
+              << ", range " << imeth::Arithmetic::range(std::span<const double>(gaps))
+              << ", float range " << imeth::Arithmetic::range(std::span<const float>(float_gaps)) << "\n";
+
+    imeth::Statistics::RunningStats first_half, second_half;
+    first_half.push(std::span(grades).first(2));
+    second_half.push(std::span(grades).subspan(2));
+    const auto running = first_half + second_half;
+    std::cout << "Running average: " << running.average() << ", std dev: " << running.standard_deviation() << "\n";
+
+    const std::vector<double> hours = {6, 7, 4, 8, 7};
+    const auto study = imeth::Statistics::linear_regression(hours, grades);
+    std::cout << "Hours vs grades: r = " << imeth::Statistics::correlation(hours, grades) << ", grade = " << study.slope
+              << " * hours + " << study.intercept << "\n";
+
+    imeth::Statistics::QuantileSketch sketch;
+    sketch.push(grades);
+    const auto restored = imeth::Statistics::QuantileSketch::deserialize(sketch.serialize());
+    std::cout << "Sketch median: " << restored.median() << " (" << restored.count() << " values)\n";
+    const auto moving = imeth::Statistics::rolling_average(grades, 3);
+    const auto moving_median = imeth::Statistics::rolling_median(grades, 3);
+    std::cout << "Moving average (3): " << moving.front() << " .. " << moving.back()
+              << ", moving median: " << moving_median.front() << " .. " << moving_median.back() << "\n";
+    auto grade_bins = imeth::Statistics::Histogram::uniform(70, 100, 3);
+    grade_bins.push(grades);
+    std::cout << "Grades per bin [70, 80, 90, 100]: " << grade_bins.count(0) << " " << grade_bins.count(1) << " "
+              << grade_bins.count(2) << "\n";
+    const imeth::Expression curve("grade / 10 + 2 ^ 3", {"grade"});
+    const std::vector<std::span<const double>> grade_column = {grades};
+    std::cout << "Curved grades: " << curve.evaluate(grade_column).front() << " (" << curve.instructions()
+              << " instructions), 2 * (3 + 4) ^ 2 = " << imeth::Expression("2 * (3 + 4) ^ 2").evaluate() << "\n";
+    auto odds = imeth::Arithmetic::sequence(1, 2, 1'000'000'000'000ull);
+    std::cout << "Odd number #1000000: " << odds[999'999] << ", terms: " << odds.size() << "\n";
+    std::cout << "Sum of two 2^62 terms: " << imeth::Arithmetic::sequence_sum(1ull << 62, 1ull << 62, 2)
+              << ", saturated term: " << imeth::Arithmetic::nth_term(~0ull - 10, 4, 5, imeth::Arithmetic::Overflow::Saturate)
+              << ", term mod 1e9+7: " << imeth::Arithmetic::nth_term_mod(~0ull - 10, 4, 5, 1'000'000'007) << "\n";
+    const std::vector<imeth::Fraction> amounts = {{1999, 100}, {550, 100}, {1, 3}};
+    const imeth::Fraction total = imeth::Fraction::sum(amounts);
+    std::cout << "Exact total: " << total.numerator() << "/" << total.denominator()
+              << ", thirds add back up: " << (imeth::Fraction(100, 3) * 3 == 100) << "\n";
+    std::cout << "log2(1024) = " << *imeth::Logarithm::log2(1024) << ", ln(1e300) = " << *imeth::Logarithm::ln(1e300)
+              << ", log(3, 81) = " << *imeth::Logarithm::log(3, 81) << "\n";
+    const double infinity = std::numeric_limits<double>::infinity();
+    std::cout << "log2(inf) = " << *imeth::Logarithm::log2(infinity) << ", log10(inf) = "
+              << *imeth::Logarithm::log10(infinity) << ", log(2, inf) = " << *imeth::Logarithm::log(2, infinity) << "\n\n";
 
     // Number properties
     std::cout << "Is 17 prime? " << (imeth::Arithmetic::is_prime(17) ? "Yes" : "No") << "\n";
+    std::cout << "Primes below 1000000: " << imeth::NumberTheory::count_primes(1000000)
+              << ", is 2^61 - 1 prime? " << (imeth::NumberTheory::is_prime((1ull << 61) - 1) ? "Yes" : "No") << "\n";
+    const auto factors = imeth::NumberTheory::factorize(600851475143);
+    std::cout << "Largest prime factor of 600851475143: " << factors.back()
+              << ", gcd(2^40, 6^20) = " << imeth::NumberTheory::gcd(1ull << 40, 3656158440062976ull) << "\n";
     std::cout << "Is 20 even? " << (imeth::Arithmetic::is_even(20) ? "Yes" : "No") << "\n";
     std::cout << "GCD of 48 and 18 = " << imeth::Arithmetic::greatest_common_divisor(48, 18) << "\n\n";
 
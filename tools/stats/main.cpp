@@ -0,0 +1,429 @@
+// imeth_stats: count, sum, mean, min, max, median and standard deviation of every column of a
+// delimited text file (CSV, TSV, whitespace separated), for files of any size.
+// Build with -DIMETH_BUILD_TOOLS=ON and a Release configuration, then run imeth_stats.
+//
+// The file is memory-mapped and cut into one chunk per thread at line boundaries. Each thread
+// parses its chunk with std::from_chars into its own RunningStats and QuantileSketch per column,
+// and the per-thread accumulators are merged in chunk order at the end. Fields that are empty
+// or not numbers are counted as missing. Quoted fields are unquoted, but a delimiter inside
+// quotes is not supported.
+#include <imeth/operation/quantile_sketch.hpp>
+#include <imeth/operation/statistics.hpp>
+#include <algorithm>
+#include <cerrno>
+#include <charconv>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <exception>
+#include <iostream>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+#ifdef _WIN32
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace {
+
+// Values buffered per column before they are pushed into the accumulators as one span
+constexpr size_t PENDING = 4096;
+// Below this many bytes per thread the file is parsed on fewer threads
+constexpr size_t MIN_CHUNK_BYTES = size_t{1} << 20;
+
+const char* const USAGE =
+    "usage: imeth_stats [options] [file]\n"
+    "Per-column statistics of a delimited text file; no file or \"-\" reads standard input.\n"
+    "\n"
+    "  -d, --delimiter C   field separator: one character, \"tab\" or \"space\" (default ,)\n"
+    "      --header        the first line holds column names\n"
+    "      --no-header     the first line is data (default: detected)\n"
+    "  -j, --threads N     parser threads (default: all hardware threads)\n"
+    "  -k N                quantile sketch size; larger is more accurate (default 200)\n"
+    "  -h, --help          show this help\n";
+
+struct Options {
+    std::string path = "-";
+    char delimiter = ',';
+    bool whitespace = false;  // fields separated by runs of spaces and tabs
+    int header = -1;          // -1 detect, 0 no, 1 yes
+    unsigned threads = 0;
+    size_t k = 200;
+};
+
+// Owns an open file handle or descriptor and closes it, so a constructor that throws after
+// opening one cannot leak it
+#ifdef _WIN32
+struct Handle {
+    HANDLE value{INVALID_HANDLE_VALUE};
+
+    Handle() = default;
+    Handle(const Handle&) = delete;
+    Handle& operator=(const Handle&) = delete;
+    ~Handle() {
+        if (value != nullptr && value != INVALID_HANDLE_VALUE) CloseHandle(value);
+    }
+};
+#else
+struct Descriptor {
+    int value{-1};
+
+    Descriptor() = default;
+    Descriptor(const Descriptor&) = delete;
+    Descriptor& operator=(const Descriptor&) = delete;
+    ~Descriptor() {
+        if (value >= 0) close(value);
+    }
+};
+#endif
+
+// Read-only view of a whole file: memory-mapped where possible, read into memory otherwise
+// (standard input, pipes)
+class Input {
+public:
+    explicit Input(const std::string& path) {
+        if (path == "-") {
+            read_all(stdin);
+            return;
+        }
+#ifdef _WIN32
+        m_file.value = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+                                   FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+        if (m_file.value == INVALID_HANDLE_VALUE) throw std::runtime_error("cannot open " + path);
+        LARGE_INTEGER size;
+        if (!GetFileSizeEx(m_file.value, &size)) throw std::runtime_error("cannot read the size of " + path);
+        m_size = static_cast<size_t>(size.QuadPart);
+        if (m_size == 0) return;
+        m_mapping.value = CreateFileMappingA(m_file.value, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        if (m_mapping.value == nullptr) throw std::runtime_error("cannot map " + path);
+        m_data = static_cast<const char*>(MapViewOfFile(m_mapping.value, FILE_MAP_READ, 0, 0, 0));
+        if (m_data == nullptr) throw std::runtime_error("cannot map " + path);
+#else
+        m_fd.value = open(path.c_str(), O_RDONLY);
+        if (m_fd.value < 0) throw std::runtime_error("cannot open " + path + ": " + std::strerror(errno));
+        struct stat info;
+        if (fstat(m_fd.value, &info) != 0) throw std::runtime_error("cannot stat " + path);
+        if (!S_ISREG(info.st_mode)) {
+            const std::unique_ptr<std::FILE, int (*)(std::FILE*)> stream(fdopen(m_fd.value, "rb"), &std::fclose);
+            if (!stream) throw std::runtime_error("cannot read " + path + ": " + std::strerror(errno));
+            m_fd.value = -1;  // closed with the stream
+            read_all(stream.get());
+            return;
+        }
+        m_size = static_cast<size_t>(info.st_size);
+        if (m_size == 0) return;
+        void* map = mmap(nullptr, m_size, PROT_READ, MAP_PRIVATE, m_fd.value, 0);
+        if (map == MAP_FAILED) throw std::runtime_error("cannot map " + path + ": " + std::strerror(errno));
+        madvise(map, m_size, MADV_SEQUENTIAL);
+        m_data = static_cast<const char*>(map);
+#endif
+    }
+
+    // The mapping is made last in the constructor, so only a fully constructed Input owns one
+    ~Input() {
+#ifdef _WIN32
+        if (m_data != nullptr && m_buffer.empty()) UnmapViewOfFile(m_data);
+#else
+        if (m_data != nullptr && m_buffer.empty()) munmap(const_cast<char*>(m_data), m_size);
+#endif
+    }
+
+    Input(const Input&) = delete;
+    Input& operator=(const Input&) = delete;
+
+    std::string_view text() const { return {m_data, m_size}; }
+
+private:
+    void read_all(std::FILE* stream) {
+        char block[1 << 16];
+        size_t got;
+        while ((got = std::fread(block, 1, sizeof block, stream)) > 0) m_buffer.append(block, got);
+        m_data = m_buffer.data();
+        m_size = m_buffer.size();
+    }
+
+    const char* m_data{};
+    size_t m_size{};
+    std::string m_buffer;
+#ifdef _WIN32
+    Handle m_file;
+    Handle m_mapping;
+#else
+    Descriptor m_fd;
+#endif
+};
+
+struct Column {
+    explicit Column(size_t k) : sketch(k) { pending.reserve(PENDING); }
+
+    void push(double value) {
+        pending.push_back(value);
+        if (pending.size() == PENDING) flush();
+    }
+
+    void flush() {
+        stats.push(pending);
+        sketch.push(pending);
+        pending.clear();
+    }
+
+    imeth::Statistics::RunningStats stats;
+    imeth::Statistics::QuantileSketch sketch;
+    std::vector<double> pending;
+};
+
+struct Chunk {
+    std::vector<Column> columns;
+    std::uint64_t rows{};
+};
+
+bool is_blank(char c) { return c == ' ' || c == '\t' || c == '\r'; }
+
+std::string_view trim(std::string_view field) {
+    while (!field.empty() && is_blank(field.front())) field.remove_prefix(1);
+    while (!field.empty() && is_blank(field.back())) field.remove_suffix(1);
+    if (field.size() >= 2 && field.front() == '"' && field.back() == '"') field = field.substr(1, field.size() - 2);
+    return field;
+}
+
+// Calls fn(index, field) for every field of one line (without its '\n')
+template <typename Fn>
+void split(std::string_view line, const Options& options, Fn&& fn) {
+    size_t index = 0;
+    if (options.whitespace) {
+        size_t pos = 0;
+        while (true) {
+            while (pos < line.size() && is_blank(line[pos])) ++pos;
+            if (pos == line.size()) return;
+            const size_t start = pos;
+            while (pos < line.size() && !is_blank(line[pos])) ++pos;
+            fn(index++, trim(line.substr(start, pos - start)));
+        }
+    }
+    while (true) {
+        const void* hit = std::memchr(line.data(), options.delimiter, line.size());
+        if (hit == nullptr) {
+            fn(index, trim(line));
+            return;
+        }
+        const size_t end = static_cast<size_t>(static_cast<const char*>(hit) - line.data());
+        fn(index++, trim(line.substr(0, end)));
+        line.remove_prefix(end + 1);
+    }
+}
+
+// Number in the field, or false for empty and non-numeric fields and NaN. Plain integers of up
+// to 15 digits are exact in a double and much cheaper to convert by hand than by from_chars.
+bool parse(std::string_view field, double& value) {
+    if (!field.empty() && field.front() == '+') field.remove_prefix(1);
+    if (field.empty()) return false;
+    const bool negative = field.front() == '-';
+    const std::string_view digits = field.substr(negative ? 1 : 0);
+    if (!digits.empty() && digits.size() <= 15) {
+        std::uint64_t n = 0;
+        size_t i = 0;
+        for (; i < digits.size() && static_cast<unsigned>(digits[i] - '0') < 10; ++i)
+            n = n * 10 + static_cast<unsigned>(digits[i] - '0');
+        if (i == digits.size()) {
+            value = negative ? -static_cast<double>(n) : static_cast<double>(n);
+            return true;
+        }
+    }
+    const auto [end, error] = std::from_chars(field.data(), field.data() + field.size(), value);
+    return error == std::errc() && end == field.data() + field.size() && !std::isnan(value);
+}
+
+bool is_blank_line(std::string_view line) {
+    return std::all_of(line.begin(), line.end(), is_blank);
+}
+
+void parse_chunk(std::string_view text, const Options& options, Chunk& chunk) {
+    while (!text.empty()) {
+        const void* newline = std::memchr(text.data(), '\n', text.size());
+        const size_t length = newline ? static_cast<size_t>(static_cast<const char*>(newline) - text.data()) : text.size();
+        const std::string_view line = text.substr(0, length);
+        text.remove_prefix(newline ? length + 1 : length);
+        if (is_blank_line(line)) continue;
+
+        ++chunk.rows;
+        split(line, options, [&](size_t index, std::string_view field) {
+            while (chunk.columns.size() <= index) chunk.columns.emplace_back(options.k);
+            double value;
+            if (parse(field, value)) chunk.columns[index].push(value);
+        });
+    }
+    for (Column& column : chunk.columns) column.flush();
+}
+
+// Cuts text into about `parts` pieces, each ending just after a '\n' (or at the end)
+std::vector<std::string_view> cut(std::string_view text, size_t parts) {
+    std::vector<std::string_view> pieces;
+    size_t start = 0;
+    for (size_t p = 1; p <= parts && start < text.size(); ++p) {
+        size_t end = p == parts ? text.size() : std::max(start, text.size() / parts * p);
+        if (end < text.size()) {
+            const size_t newline = text.find('\n', end);
+            end = newline == std::string_view::npos ? text.size() : newline + 1;
+        }
+        pieces.push_back(text.substr(start, end - start));
+        start = end;
+    }
+    return pieces;
+}
+
+Options parse_options(int argc, char** argv) {
+    Options options;
+    bool have_path = false;
+    for (int i = 1; i < argc; ++i) {
+        const std::string arg = argv[i];
+        const auto value = [&]() -> std::string {
+            if (i + 1 >= argc) throw std::invalid_argument(arg + " needs a value");
+            return argv[++i];
+        };
+        if (arg == "-h" || arg == "--help") {
+            std::cout << USAGE;
+            std::exit(0);
+        } else if (arg == "-d" || arg == "--delimiter") {
+            const std::string d = value();
+            if (d == "tab" || d == "\\t") {
+                options.delimiter = '\t';
+            } else if (d == "space") {
+                options.whitespace = true;
+            } else if (d.size() == 1 && d[0] != '\n' && d[0] != '"') {
+                options.delimiter = d[0];
+            } else {
+                throw std::invalid_argument("unsupported delimiter '" + d + "'");
+            }
+        } else if (arg == "--header") {
+            options.header = 1;
+        } else if (arg == "--no-header") {
+            options.header = 0;
+        } else if (arg == "-j" || arg == "--threads") {
+            options.threads = static_cast<unsigned>(std::stoul(value()));
+        } else if (arg == "-k") {
+            options.k = std::stoul(value());
+        } else if (arg.size() > 1 && arg[0] == '-') {
+            throw std::invalid_argument("unknown option " + arg);
+        } else if (!have_path) {
+            options.path = arg;
+            have_path = true;
+        } else {
+            throw std::invalid_argument("only one input file is supported");
+        }
+    }
+    if (options.threads == 0) options.threads = std::max(1u, std::thread::hardware_concurrency());
+    if (options.k < 8) throw std::invalid_argument("-k must be at least 8");
+    return options;
+}
+
+void print(const std::vector<std::string>& names, const Chunk& total) {
+    size_t width = 6;
+    for (const std::string& name : names) width = std::max(width, name.size());
+    const int w = static_cast<int>(width);
+
+    std::printf("%-*s %12s %10s %16s %14s %14s %14s %14s %14s\n", w, "column", "count", "missing", "sum", "mean",
+                "min", "max", "median*", "std dev");
+    double rank_error = 0.0;
+    for (size_t c = 0; c < total.columns.size(); ++c) {
+        const Column& column = total.columns[c];
+        const auto& s = column.stats;
+        // Everything that was not a number, including fields missing from short rows
+        const std::uint64_t missing = total.rows - s.count();
+        std::printf("%-*s %12zu %10llu", w, names[c].c_str(), s.count(), static_cast<unsigned long long>(missing));
+        if (s.empty()) {
+            std::printf(" %16s %14s %14s %14s %14s %14s\n", "-", "-", "-", "-", "-", "-");
+            continue;
+        }
+        std::printf(" %16.10g %14.8g %14.8g %14.8g %14.8g %14.8g\n", s.sum(), s.average(), s.minimum(),
+                    s.maximum(), column.sketch.median(), s.standard_deviation());
+        rank_error = column.sketch.normalized_rank_error();
+    }
+    std::printf("* approximate: within %.2g%% of the true median by rank\n", 100.0 * rank_error);
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    try {
+        const Options options = parse_options(argc, argv);
+        const auto start = std::chrono::steady_clock::now();
+        const Input input(options.path);
+        std::string_view text = input.text();
+
+        // Header: named explicitly, or detected as a first line with a non-numeric field
+        std::vector<std::string> names;
+        const size_t first_end = std::min(text.find('\n'), text.size());
+        const std::string_view first = text.substr(0, first_end);
+        bool header = options.header == 1;
+        if (options.header == -1) {
+            split(first, options, [&](size_t, std::string_view field) {
+                double value;
+                if (!field.empty() && !parse(field, value)) header = true;
+            });
+        }
+        if (header) {
+            split(first, options, [&](size_t, std::string_view field) { names.emplace_back(field); });
+            text.remove_prefix(std::min(text.size(), first_end + 1));
+        }
+
+        const size_t parts = std::clamp<size_t>(text.size() / MIN_CHUNK_BYTES, 1, options.threads);
+        const std::vector<std::string_view> pieces = cut(text, parts);
+        std::vector<Chunk> chunks(pieces.size());
+        std::vector<std::exception_ptr> errors(pieces.size());
+        std::vector<std::thread> workers;
+        const auto work = [&](size_t p) {
+            try {
+                parse_chunk(pieces[p], options, chunks[p]);
+            } catch (...) {
+                errors[p] = std::current_exception();
+            }
+        };
+        for (size_t p = 1; p < pieces.size(); ++p) workers.emplace_back(work, p);
+        if (!pieces.empty()) work(0);
+        for (std::thread& worker : workers) worker.join();
+        for (const std::exception_ptr& error : errors)
+            if (error) std::rethrow_exception(error);
+
+        // Merging in chunk order keeps the output independent of thread timing
+        Chunk total;
+        for (const Chunk& chunk : chunks) {
+            total.rows += chunk.rows;
+            for (size_t c = 0; c < chunk.columns.size(); ++c) {
+                if (total.columns.size() <= c) total.columns.emplace_back(options.k);
+                total.columns[c].stats += chunk.columns[c].stats;
+                total.columns[c].sketch += chunk.columns[c].sketch;
+            }
+        }
+        while (total.columns.size() < names.size()) total.columns.emplace_back(options.k);
+        if (total.rows == 0 || total.columns.empty()) {
+            std::cerr << "imeth_stats: no data\n";
+            return 1;
+        }
+        while (names.size() < total.columns.size()) names.push_back("column " + std::to_string(names.size() + 1));
+
+        print(names, total);
+        std::fflush(stdout);
+        const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+        const double megabytes = static_cast<double>(input.text().size()) / 1e6;
+        std::fprintf(stderr, "%llu rows, %.1f MB in %.3f s (%.0f MB/s, %zu threads)\n",
+                     static_cast<unsigned long long>(total.rows), megabytes, elapsed.count(),
+                     megabytes / elapsed.count(), pieces.size());
+        return 0;
+    } catch (const std::exception& e) {
+        std::cerr << "imeth_stats: " << e.what() << "\n";
+        return 1;
+    }
+}